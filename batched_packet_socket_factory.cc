@@ -0,0 +1,167 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/batched_packet_socket_factory.h"
+
+#include "libp2p_peerconnection/socket_read_batch.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_base/trace_event.h"
+
+namespace libp2p_peerconnection {
+
+BatchedAsyncUdpSocket::BatchedAsyncUdpSocket(rtc::Socket* socket)
+    : socket_(socket),
+      alive_(webrtc::PendingTaskSafetyFlag::Create()),
+      buffer_(new char[kBufferSize]) {
+  RTC_DCHECK(socket_);
+  socket_->SignalReadEvent.connect(this, &BatchedAsyncUdpSocket::OnReadEvent);
+  socket_->SignalWriteEvent.connect(this,
+                                    &BatchedAsyncUdpSocket::OnWriteEvent);
+}
+
+BatchedAsyncUdpSocket::~BatchedAsyncUdpSocket() {
+  alive_->SetNotAlive();
+}
+
+rtc::SocketAddress BatchedAsyncUdpSocket::GetLocalAddress() const {
+  return socket_->GetLocalAddress();
+}
+
+rtc::SocketAddress BatchedAsyncUdpSocket::GetRemoteAddress() const {
+  return socket_->GetRemoteAddress();
+}
+
+int BatchedAsyncUdpSocket::Send(const void* pv,
+                                size_t cb,
+                                const rtc::PacketOptions& options) {
+  rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
+                              options.info_signaled_after_sent);
+  rtc::CopySocketInformationToPacketInfo(cb, *this, false, &sent_packet.info);
+  int ret = socket_->Send(pv, cb);
+  SignalSentPacket(this, sent_packet);
+  return ret;
+}
+
+int BatchedAsyncUdpSocket::SendTo(const void* pv,
+                                  size_t cb,
+                                  const rtc::SocketAddress& addr,
+                                  const rtc::PacketOptions& options) {
+  rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
+                              options.info_signaled_after_sent);
+  rtc::CopySocketInformationToPacketInfo(cb, *this, true, &sent_packet.info);
+  int ret = socket_->SendTo(pv, cb, addr);
+  SignalSentPacket(this, sent_packet);
+  return ret;
+}
+
+int BatchedAsyncUdpSocket::Close() {
+  return socket_->Close();
+}
+
+rtc::AsyncPacketSocket::State BatchedAsyncUdpSocket::GetState() const {
+  return STATE_BOUND;
+}
+
+int BatchedAsyncUdpSocket::GetOption(rtc::Socket::Option opt, int* value) {
+  return socket_->GetOption(opt, value);
+}
+
+int BatchedAsyncUdpSocket::SetOption(rtc::Socket::Option opt, int value) {
+  return socket_->SetOption(opt, value);
+}
+
+int BatchedAsyncUdpSocket::GetError() const {
+  return socket_->GetError();
+}
+
+void BatchedAsyncUdpSocket::SetError(int error) {
+  socket_->SetError(error);
+}
+
+void BatchedAsyncUdpSocket::OnReadEvent(rtc::Socket* socket) {
+  RTC_DCHECK(socket_.get() == socket);
+  TRACE_EVENT0("webrtc", "BatchedAsyncUdpSocket::OnReadEvent");
+  // Keeps the flag itself alive if a callback destroys this socket.
+  rtc::scoped_refptr<webrtc::PendingTaskSafetyFlag> alive = alive_;
+  SocketReadBatch batch;
+  for (int i = 0; i < kMaxDatagramsPerReadEvent; ++i) {
+    rtc::SocketAddress remote_addr;
+    int64_t timestamp = -1;
+    int len = socket_->RecvFrom(buffer_.get(), kBufferSize, &remote_addr,
+                                &timestamp);
+    if (len < 0) {
+      // Would block: the socket is drained. Anything else is typically an
+      // ICMP error for an earlier send, which is normal during ICE.
+      if (!socket_->IsBlocking()) {
+        RTC_LOG(LS_INFO) << "BatchedAsyncUdpSocket["
+                         << socket_->GetLocalAddress().ToSensitiveString()
+                         << "] receive failed with error "
+                         << socket_->GetError();
+      }
+      return;
+    }
+    SignalReadPacket(this, buffer_.get(), static_cast<size_t>(len),
+                     remote_addr,
+                     timestamp > -1 ? timestamp : rtc::TimeMicros());
+    if (!alive->alive()) {
+      return;
+    }
+  }
+}
+
+void BatchedAsyncUdpSocket::OnWriteEvent(rtc::Socket* socket) {
+  SignalReadyToSend(this);
+}
+
+BatchedPacketSocketFactory::BatchedPacketSocketFactory(
+    rtc::SocketFactory* socket_factory)
+    : libice::BasicPacketSocketFactory(socket_factory),
+      socket_factory_(socket_factory) {}
+
+BatchedPacketSocketFactory::~BatchedPacketSocketFactory() = default;
+
+rtc::AsyncPacketSocket* BatchedPacketSocketFactory::CreateUdpSocket(
+    const rtc::SocketAddress& address,
+    uint16_t min_port,
+    uint16_t max_port) {
+  rtc::Socket* socket =
+      socket_factory_->CreateSocket(address.family(), SOCK_DGRAM);
+  if (!socket) {
+    return nullptr;
+  }
+  int ret = -1;
+  if (min_port == 0 && max_port == 0) {
+    ret = socket->Bind(address);
+  } else {
+    for (int port = min_port; ret < 0 && port <= max_port; ++port) {
+      ret = socket->Bind(rtc::SocketAddress(address.ipaddr(), port));
+    }
+  }
+  if (ret < 0) {
+    RTC_LOG(LS_ERROR) << "UDP bind failed with error " << socket->GetError();
+    delete socket;
+    return nullptr;
+  }
+  return new BatchedAsyncUdpSocket(socket);
+}
+
+}  // namespace libp2p_peerconnection
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_BATCHED_PACKET_SOCKET_FACTORY_H_
+#define _C_PC_BATCHED_PACKET_SOCKET_FACTORY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "api/scoped_refptr.h"
+#include "libice/basic_packet_socket_factory.h"
+#include "rtc_base/async_packet_socket.h"
+#include "rtc_base/socket.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/socket_factory.h"
+#include "rtc_base/task_utils/pending_task_safety_flag.h"
+
+namespace libp2p_peerconnection {
+
+// UDP socket that reads every queued datagram in one read event, instead of
+// one datagram per event like rtc::AsyncUDPSocket. The reads run inside a
+// SocketReadBatch, so the receivers up the stack flush their batch before
+// the event returns.
+class BatchedAsyncUdpSocket : public rtc::AsyncPacketSocket {
+ public:
+  // Bounds one read event, so a flood can't starve the rest of the thread.
+  static constexpr int kMaxDatagramsPerReadEvent = 64;
+
+  // Takes ownership of `socket`.
+  explicit BatchedAsyncUdpSocket(rtc::Socket* socket);
+  ~BatchedAsyncUdpSocket() override;
+
+  rtc::SocketAddress GetLocalAddress() const override;
+  rtc::SocketAddress GetRemoteAddress() const override;
+  int Send(const void* pv,
+           size_t cb,
+           const rtc::PacketOptions& options) override;
+  int SendTo(const void* pv,
+             size_t cb,
+             const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options) override;
+  int Close() override;
+
+  State GetState() const override;
+  int GetOption(rtc::Socket::Option opt, int* value) override;
+  int SetOption(rtc::Socket::Option opt, int value) override;
+  int GetError() const override;
+  void SetError(int error) override;
+
+ private:
+  void OnReadEvent(rtc::Socket* socket);
+  void OnWriteEvent(rtc::Socket* socket);
+
+  std::unique_ptr<rtc::Socket> socket_;
+  // A read callback may destroy this socket.
+  rtc::scoped_refptr<webrtc::PendingTaskSafetyFlag> alive_;
+  static constexpr size_t kBufferSize = 64 * 1024;
+  std::unique_ptr<char[]> buffer_;
+};
+
+// Creates BatchedAsyncUdpSocket for UDP; TCP sockets come from the base.
+class BatchedPacketSocketFactory : public libice::BasicPacketSocketFactory {
+ public:
+  explicit BatchedPacketSocketFactory(rtc::SocketFactory* socket_factory);
+  ~BatchedPacketSocketFactory() override;
+
+  rtc::AsyncPacketSocket* CreateUdpSocket(const rtc::SocketAddress& address,
+                                          uint16_t min_port,
+                                          uint16_t max_port) override;
+
+ private:
+  rtc::SocketFactory* const socket_factory_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_BATCHED_PACKET_SOCKET_FACTORY_H_
@@ -0,0 +1,46 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/bench/bench_rtp_packet.h"
+
+#include "rtc_base/byte_io.h"
+#include "rtc_base/checks.h"
+
+namespace libp2p_peerconnection {
+
+void WriteBenchRtpHeader(rtc::CopyOnWriteBuffer* packet,
+                         uint16_t sequence_number,
+                         uint32_t timestamp,
+                         uint32_t ssrc) {
+  RTC_DCHECK_GE(packet->size(), kBenchRtpHeaderSize);
+  WriteBenchRtpHeader(packet->MutableData(), sequence_number, timestamp, ssrc);
+}
+
+void WriteBenchRtpHeader(uint8_t* data,
+                         uint16_t sequence_number,
+                         uint32_t timestamp,
+                         uint32_t ssrc) {
+  data[0] = 0x80;
+  data[1] = kBenchRtpPayloadType;
+  rtc::ByteWriter<uint16_t>::WriteBigEndian(data + 2, sequence_number);
+  rtc::ByteWriter<uint32_t>::WriteBigEndian(data + 4, timestamp);
+  rtc::ByteWriter<uint32_t>::WriteBigEndian(data + 8, ssrc);
+}
+
+}  // namespace libp2p_peerconnection
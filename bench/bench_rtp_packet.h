@@ -0,0 +1,47 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_BENCH_BENCH_RTP_PACKET_H_
+#define _C_PC_BENCH_BENCH_RTP_PACKET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtc_base/copy_on_write_buffer.h"
+
+namespace libp2p_peerconnection {
+
+constexpr size_t kBenchRtpHeaderSize = 12;
+constexpr uint8_t kBenchRtpPayloadType = 96;
+
+// Writes a 12 byte RTP header without extensions at the front of `packet`,
+// which must be uniquely owned and at least kBenchRtpHeaderSize long.
+void WriteBenchRtpHeader(rtc::CopyOnWriteBuffer* packet,
+                         uint16_t sequence_number,
+                         uint32_t timestamp,
+                         uint32_t ssrc);
+// Same, for a raw buffer of at least kBenchRtpHeaderSize bytes.
+void WriteBenchRtpHeader(uint8_t* data,
+                         uint16_t sequence_number,
+                         uint32_t timestamp,
+                         uint32_t ssrc);
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_BENCH_BENCH_RTP_PACKET_H_
@@ -0,0 +1,126 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/bench/loopback_dtls_srtp_pair.h"
+
+#include <string>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/rtc_certificate.h"
+#include "rtc_base/ssl_adapter.h"
+#include "rtc_base/ssl_fingerprint.h"
+#include "rtc_base/ssl_identity.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+constexpr int kPollIntervalMs = 5;
+
+rtc::scoped_refptr<rtc::RTCCertificate> CreateCertificate(
+    const std::string& name) {
+  return rtc::RTCCertificate::Create(
+      rtc::SSLIdentity::Create(name, rtc::KT_ECDSA));
+}
+
+bool SetRemoteFingerprint(libice::DtlsTransport* dtls,
+                          const rtc::RTCCertificate& remote_certificate) {
+  std::unique_ptr<rtc::SSLFingerprint> fingerprint =
+      rtc::SSLFingerprint::CreateFromCertificate(remote_certificate);
+  return fingerprint &&
+         dtls->SetRemoteFingerprint(fingerprint->algorithm,
+                                    fingerprint->digest.cdata(),
+                                    fingerprint->digest.size());
+}
+
+}  // namespace
+
+void InitializeSslForBench() {
+  static const bool initialized = rtc::InitializeSSL();
+  RTC_CHECK(initialized);
+}
+
+LoopbackDtlsSrtpPair::LoopbackDtlsSrtpPair(
+    const libmedia_transfer_protocol::CryptoOptions& crypto_options)
+    : sender_ice_("bench_sender"), receiver_ice_("bench_receiver") {
+  InitializeSslForBench();
+  sender_ice_.SetIceRole(libice::ICEROLE_CONTROLLING);
+  receiver_ice_.SetIceRole(libice::ICEROLE_CONTROLLED);
+  sender_dtls_ = std::make_unique<libice::DtlsTransport>(
+      &sender_ice_, crypto_options, nullptr, rtc::SSL_PROTOCOL_DTLS_12);
+  receiver_dtls_ = std::make_unique<libice::DtlsTransport>(
+      &receiver_ice_, crypto_options, nullptr, rtc::SSL_PROTOCOL_DTLS_12);
+
+  rtc::scoped_refptr<rtc::RTCCertificate> sender_certificate =
+      CreateCertificate("bench_sender");
+  rtc::scoped_refptr<rtc::RTCCertificate> receiver_certificate =
+      CreateCertificate("bench_receiver");
+  sender_dtls_->SetLocalCertificate(sender_certificate);
+  receiver_dtls_->SetLocalCertificate(receiver_certificate);
+  sender_dtls_->SetDtlsRole(rtc::SSL_CLIENT);
+  receiver_dtls_->SetDtlsRole(rtc::SSL_SERVER);
+  RTC_CHECK(SetRemoteFingerprint(sender_dtls_.get(), *receiver_certificate));
+  RTC_CHECK(SetRemoteFingerprint(receiver_dtls_.get(), *sender_certificate));
+
+  // RTCP is muxed, as the controller sets it up for BUNDLE.
+  sender_srtp_ = std::make_unique<DtlsSrtpTransport>(/*rtcp_mux_enabled=*/true);
+  receiver_srtp_ =
+      std::make_unique<DtlsSrtpTransport>(/*rtcp_mux_enabled=*/true);
+  sender_srtp_->SetDtlsTransports(sender_dtls_.get(), nullptr);
+  receiver_srtp_->SetDtlsTransports(receiver_dtls_.get(), nullptr);
+  receiver_srtp_->SetInboundBatchingEnabled(true);
+}
+
+LoopbackDtlsSrtpPair::~LoopbackDtlsSrtpPair() {
+  // The SRTP transports listen to the DTLS transports, which listen to the
+  // loopback; tear down from the top.
+  sender_srtp_.reset();
+  receiver_srtp_.reset();
+  sender_dtls_.reset();
+  receiver_dtls_.reset();
+}
+
+bool LoopbackDtlsSrtpPair::Connect(int timeout_ms) {
+  StartHandshake();
+  const int64_t deadline_ms = rtc::TimeMillis() + timeout_ms;
+  while (!FinishHandshake()) {
+    if (rtc::TimeMillis() >= deadline_ms) {
+      return false;
+    }
+    rtc::Thread::Current()->ProcessMessages(kPollIntervalMs);
+  }
+  return true;
+}
+
+void LoopbackDtlsSrtpPair::StartHandshake() {
+  LoopbackIceTransport::Connect(&sender_ice_, &receiver_ice_);
+}
+
+bool LoopbackDtlsSrtpPair::FinishHandshake() {
+  if (!sender_srtp_->IsSrtpActive() || !receiver_srtp_->IsSrtpActive()) {
+    return false;
+  }
+  sender_ice_.set_synchronous(true);
+  receiver_ice_.set_synchronous(true);
+  return true;
+}
+
+}  // namespace libp2p_peerconnection
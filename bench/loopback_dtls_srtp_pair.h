@@ -0,0 +1,72 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_BENCH_LOOPBACK_DTLS_SRTP_PAIR_H_
+#define _C_PC_BENCH_LOOPBACK_DTLS_SRTP_PAIR_H_
+
+#include <memory>
+
+#include "libice/dtls_transport.h"
+#include "libmedia_transfer_protocol/crypto/crypto_options.h"
+#include "libp2p_peerconnection/bench/loopback_ice_transport.h"
+#include "libp2p_peerconnection/dtls_srtp_transport.h"
+
+namespace libp2p_peerconnection {
+
+// Two DtlsSrtpTransports on the current thread, joined by
+// LoopbackIceTransports: `sender()` is the DTLS client, `receiver()` the
+// server. Connect() runs a real DTLS handshake and returns once both ends
+// have their SRTP sessions, after which the loopback delivers synchronously.
+class LoopbackDtlsSrtpPair {
+ public:
+  explicit LoopbackDtlsSrtpPair(
+      const libmedia_transfer_protocol::CryptoOptions& crypto_options);
+  ~LoopbackDtlsSrtpPair();
+
+  LoopbackDtlsSrtpPair(const LoopbackDtlsSrtpPair&) = delete;
+  LoopbackDtlsSrtpPair& operator=(const LoopbackDtlsSrtpPair&) = delete;
+
+  // Pumps the current thread until the handshake is done or `timeout_ms`
+  // passed. Returns false on timeout.
+  bool Connect(int timeout_ms);
+
+  // The two halves of Connect(), for a pair living on a thread that runs its
+  // own message loop: StartHandshake() once, then FinishHandshake() until it
+  // returns true. Both have to be called on the pair's thread.
+  void StartHandshake();
+  bool FinishHandshake();
+
+  DtlsSrtpTransport* sender() { return sender_srtp_.get(); }
+  DtlsSrtpTransport* receiver() { return receiver_srtp_.get(); }
+
+ private:
+  LoopbackIceTransport sender_ice_;
+  LoopbackIceTransport receiver_ice_;
+  std::unique_ptr<libice::DtlsTransport> sender_dtls_;
+  std::unique_ptr<libice::DtlsTransport> receiver_dtls_;
+  std::unique_ptr<DtlsSrtpTransport> sender_srtp_;
+  std::unique_ptr<DtlsSrtpTransport> receiver_srtp_;
+};
+
+// rtc::InitializeSSL() once per process.
+void InitializeSslForBench();
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_BENCH_LOOPBACK_DTLS_SRTP_PAIR_H_
@@ -0,0 +1,160 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/bench/loopback_ice_transport.h"
+
+#include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
+
+namespace libp2p_peerconnection {
+
+LoopbackIceTransport::LoopbackIceTransport(const std::string& name)
+    : name_(name) {}
+
+LoopbackIceTransport::~LoopbackIceTransport() {
+  if (peer_) {
+    peer_->peer_ = nullptr;
+    peer_->SetWritable(false);
+  }
+}
+
+void LoopbackIceTransport::Connect(LoopbackIceTransport* a,
+                                   LoopbackIceTransport* b) {
+  RTC_DCHECK(!a->peer_ && !b->peer_);
+  a->peer_ = b;
+  b->peer_ = a;
+  a->SetWritable(true);
+  b->SetWritable(true);
+}
+
+libice::IceTransportState LoopbackIceTransport::GetState() const {
+  return writable_ ? libice::IceTransportState::STATE_COMPLETED
+                   : libice::IceTransportState::STATE_INIT;
+}
+
+webrtc::IceTransportState LoopbackIceTransport::GetIceTransportState() const {
+  return writable_ ? webrtc::IceTransportState::kCompleted
+                   : webrtc::IceTransportState::kNew;
+}
+
+int LoopbackIceTransport::component() const {
+  return libice::ICE_CANDIDATE_COMPONENT_RTP;
+}
+
+libice::IceRole LoopbackIceTransport::GetIceRole() const {
+  return role_;
+}
+
+void LoopbackIceTransport::SetIceRole(libice::IceRole role) {
+  role_ = role;
+}
+
+libice::IceGatheringState LoopbackIceTransport::gathering_state() const {
+  return libice::kIceGatheringComplete;
+}
+
+bool LoopbackIceTransport::GetStats(
+    libice::IceTransportStats* ice_transport_stats) {
+  return false;
+}
+
+absl::optional<int> LoopbackIceTransport::GetRttEstimate() {
+  return absl::nullopt;
+}
+
+const libice::Connection* LoopbackIceTransport::selected_connection() const {
+  return nullptr;
+}
+
+absl::optional<const libice::CandidatePair>
+LoopbackIceTransport::GetSelectedCandidatePair() const {
+  return absl::nullopt;
+}
+
+const std::string& LoopbackIceTransport::transport_name() const {
+  return name_;
+}
+
+bool LoopbackIceTransport::writable() const {
+  return writable_;
+}
+
+bool LoopbackIceTransport::receiving() const {
+  return writable_;
+}
+
+int LoopbackIceTransport::SendPacket(const char* data,
+                                     size_t len,
+                                     const rtc::PacketOptions& options,
+                                     int flags) {
+  if (!peer_ || !writable_) {
+    return -1;
+  }
+  ++sent_packets_;
+  const int64_t now_us = rtc::TimeMicros();
+  SignalSentPacket(this, rtc::SentPacket(options.packet_id, now_us / 1000));
+  if (synchronous_) {
+    // The receive path runs before SendPacket() returns, like a socket read
+    // event that follows the write immediately.
+    peer_->SignalReadPacket(peer_, data, len, now_us, 0);
+    return static_cast<int>(len);
+  }
+  rtc::Thread::Current()->PostTask(webrtc::ToQueuedTask(
+      safety_.flag(), [this, packet = rtc::CopyOnWriteBuffer(data, len)]() {
+        if (peer_) {
+          peer_->SignalReadPacket(peer_, packet.cdata<char>(), packet.size(),
+                                  rtc::TimeMicros(), 0);
+        }
+      }));
+  return static_cast<int>(len);
+}
+
+int LoopbackIceTransport::SetOption(rtc::Socket::Option opt, int value) {
+  return 0;
+}
+
+bool LoopbackIceTransport::GetOption(rtc::Socket::Option opt, int* value) {
+  return false;
+}
+
+int LoopbackIceTransport::GetError() {
+  return 0;
+}
+
+absl::optional<rtc::NetworkRoute> LoopbackIceTransport::network_route() const {
+  return absl::nullopt;
+}
+
+void LoopbackIceTransport::SetWritable(bool writable) {
+  if (writable_ == writable) {
+    return;
+  }
+  writable_ = writable;
+  SignalReceivingState(this);
+  SignalWritableState(this);
+  if (writable_) {
+    SignalReadyToSend(this);
+  }
+}
+
+}  // namespace libp2p_peerconnection
@@ -0,0 +1,111 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_BENCH_LOOPBACK_ICE_TRANSPORT_H_
+#define _C_PC_BENCH_LOOPBACK_ICE_TRANSPORT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "absl/types/optional.h"
+#include "libice/ice_transport_internal.h"
+#include "rtc_base/async_packet_socket.h"
+#include "rtc_base/network_route.h"
+#include "rtc_base/socket.h"
+#include "rtc_base/task_utils/pending_task_safety_flag.h"
+
+namespace libp2p_peerconnection {
+
+// ICE transport stand-in that hands every packet to its peer on the same
+// thread. Two of them joined with Connect() carry a real DTLS handshake and
+// SRTP traffic between two DtlsSrtpTransports without sockets, so the bench
+// measures the transport stack and nothing else.
+//
+// Packets are posted to the thread by default: the SSL stream adapter must
+// not be re-entered from inside its own write during the handshake. Once
+// DTLS is up, set_synchronous(true) delivers inside SendPacket() instead, so
+// a burst is sent and received without going through the message queue.
+class LoopbackIceTransport : public libice::IceTransportInternal {
+ public:
+  explicit LoopbackIceTransport(const std::string& name);
+  ~LoopbackIceTransport() override;
+
+  LoopbackIceTransport(const LoopbackIceTransport&) = delete;
+  LoopbackIceTransport& operator=(const LoopbackIceTransport&) = delete;
+
+  // Joins `a` and `b` and makes both writable, which starts DTLS on the
+  // DtlsTransports on top of them.
+  static void Connect(LoopbackIceTransport* a, LoopbackIceTransport* b);
+
+  void set_synchronous(bool synchronous) { synchronous_ = synchronous; }
+  int64_t sent_packets() const { return sent_packets_; }
+
+  // libice::IceTransportInternal.
+  libice::IceTransportState GetState() const override;
+  webrtc::IceTransportState GetIceTransportState() const override;
+  int component() const override;
+  libice::IceRole GetIceRole() const override;
+  void SetIceRole(libice::IceRole role) override;
+  void SetIceTiebreaker(uint64_t tiebreaker) override {}
+  void SetIceParameters(const libice::IceParameters& ice_params) override {}
+  void SetRemoteIceParameters(
+      const libice::IceParameters& ice_params) override {}
+  void SetRemoteIceMode(libice::IceMode mode) override {}
+  void SetIceConfig(const libice::IceConfig& config) override {}
+  void MaybeStartGathering() override {}
+  void AddRemoteCandidate(const libice::Candidate& candidate) override {}
+  void RemoveRemoteCandidate(const libice::Candidate& candidate) override {}
+  void RemoveAllRemoteCandidates() override {}
+  libice::IceGatheringState gathering_state() const override;
+  bool GetStats(libice::IceTransportStats* ice_transport_stats) override;
+  absl::optional<int> GetRttEstimate() override;
+  const libice::Connection* selected_connection() const override;
+  absl::optional<const libice::CandidatePair> GetSelectedCandidatePair()
+      const override;
+
+  // libice::PacketTransportInternal.
+  const std::string& transport_name() const override;
+  bool writable() const override;
+  bool receiving() const override;
+  int SendPacket(const char* data,
+                 size_t len,
+                 const rtc::PacketOptions& options,
+                 int flags) override;
+  int SetOption(rtc::Socket::Option opt, int value) override;
+  bool GetOption(rtc::Socket::Option opt, int* value) override;
+  int GetError() override;
+  absl::optional<rtc::NetworkRoute> network_route() const override;
+
+ private:
+  void SetWritable(bool writable);
+
+  const std::string name_;
+  libice::IceRole role_ = libice::ICEROLE_UNKNOWN;
+  LoopbackIceTransport* peer_ = nullptr;
+  bool writable_ = false;
+  bool synchronous_ = false;
+  int64_t sent_packets_ = 0;
+  webrtc::ScopedTaskSafety safety_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_BENCH_LOOPBACK_ICE_TRANSPORT_H_
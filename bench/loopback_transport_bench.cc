@@ -0,0 +1,157 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+// End-to-end throughput of the SRTP transport stack: RTP packets go from one
+// DtlsSrtpTransport through SRTP protect, DTLS bypass and a loopback "socket"
+// into the other one, which unprotects and demuxes them to a sink. Both ends
+// run on the benchmark thread after a real DTLS handshake.
+//
+// Run with --benchmark_format=json (or --benchmark_out=<file>) for the JSON
+// report; every run carries packets/bytes per second, the burst-to-sink
+// latency p50/p99 and the heap allocations per packet as counters.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "libp2p_peerconnection/bench/bench_rtp_packet.h"
+#include "libp2p_peerconnection/bench/loopback_dtls_srtp_pair.h"
+#include "libp2p_peerconnection/packet_buffer_pool.h"
+#include "libp2p_peerconnection/socket_read_batch.h"
+#include "libp2p_peerconnection/srtp_transport.h"
+#include "libp2p_peerconnection/transport_perf_stats.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
+
+namespace libp2p_peerconnection {
+namespace {
+
+constexpr uint32_t kSsrc = 0x11223344;
+constexpr int kHandshakeTimeoutMs = 5000;
+// Same flag the transport controller passes: SRTP packets bypass DTLS.
+constexpr int kSrtpBypassFlags = 1;
+
+class CountingSink : public webrtc::RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const webrtc::RtpPacketReceived& packet) override {
+    ++packets_;
+    latency_us_.Add(rtc::TimeMicros() - burst_start_us_);
+  }
+
+  void set_burst_start_us(int64_t burst_start_us) {
+    burst_start_us_ = burst_start_us;
+  }
+  int64_t packets() const { return packets_; }
+  const PacketLatencyHistogram& latency_us() const { return latency_us_; }
+
+ private:
+  int64_t burst_start_us_ = 0;
+  int64_t packets_ = 0;
+  PacketLatencyHistogram latency_us_;
+};
+
+// Args: RTP packet size in bytes, packets per burst. A burst is handed to
+// SendRtpPackets() in one call, like one flush of the pacer queue, and is
+// received inside one SocketReadBatch, like one socket read event.
+void BM_LoopbackSrtp(benchmark::State& state) {
+  const size_t packet_size = static_cast<size_t>(state.range(0));
+  const size_t burst_size = static_cast<size_t>(state.range(1));
+
+  rtc::AutoThread thread;
+  LoopbackDtlsSrtpPair pair{libmedia_transfer_protocol::CryptoOptions()};
+  if (!pair.Connect(kHandshakeTimeoutMs)) {
+    state.SkipWithError("DTLS handshake did not finish");
+    return;
+  }
+  CountingSink sink;
+  webrtc::RtpDemuxerCriteria criteria;
+  criteria.ssrcs.insert(kSsrc);
+  pair.receiver()->RegisterRtpDemuxerSink(criteria, &sink);
+
+  PacketBufferPool* pool = PacketBufferPool::Current();
+  const std::vector<uint8_t> payload(packet_size, 0xab);
+  std::vector<rtc::CopyOnWriteBuffer> burst(burst_size);
+  std::vector<rtc::CopyOnWriteBuffer*> burst_refs(burst_size);
+  uint16_t sequence_number = 0;
+  uint32_t timestamp = 0;
+
+  const PacketBufferPool::Stats pool_before = pool->stats();
+  const SrtpSendBufferStats send_before = pair.sender()->send_buffer_stats();
+  for (auto _ : state) {
+    for (size_t i = 0; i < burst_size; ++i) {
+      // As on the network thread: sent buffers come from, and go back to,
+      // the thread's pool.
+      burst[i] = pool->Acquire(payload.data(), payload.size());
+      WriteBenchRtpHeader(&burst[i], sequence_number++, timestamp, kSsrc);
+      burst_refs[i] = &burst[i];
+    }
+    timestamp += 3000;
+    {
+      SocketReadBatch read_event;
+      sink.set_burst_start_us(rtc::TimeMicros());
+      pair.sender()->SendRtpPackets(burst_refs, rtc::PacketOptions(),
+                                    kSrtpBypassFlags);
+    }
+    for (rtc::CopyOnWriteBuffer& packet : burst) {
+      pool->Release(std::move(packet));
+    }
+  }
+  pair.receiver()->UnregisterRtpDemuxerSink(&sink);
+
+  const int64_t sent = static_cast<int64_t>(state.iterations() * burst_size);
+  if (sink.packets() != sent) {
+    state.SkipWithError("packets were lost on the loopback");
+    return;
+  }
+  const SrtpSendBufferStats& send_after = pair.sender()->send_buffer_stats();
+  const PacketBufferPool::Stats& pool_after = pool->stats();
+  const int64_t allocations = (send_after.allocations - send_before.allocations) +
+                              (pool_after.misses - pool_before.misses);
+  state.SetItemsProcessed(sent);
+  state.SetBytesProcessed(sent * static_cast<int64_t>(packet_size));
+  state.counters["packets_per_second"] =
+      benchmark::Counter(static_cast<double>(sent), benchmark::Counter::kIsRate);
+  state.counters["latency_p50_us"] =
+      static_cast<double>(sink.latency_us().Percentile(50));
+  state.counters["latency_p99_us"] =
+      static_cast<double>(sink.latency_us().Percentile(99));
+  state.counters["allocations_per_packet"] =
+      sent > 0 ? static_cast<double>(allocations) / sent : 0.0;
+  state.counters["copies_per_packet"] =
+      sent > 0 ? static_cast<double>(send_after.copies - send_before.copies) /
+                     sent
+               : 0.0;
+  if (kTransportPerfLatencyEnabled) {
+    // Read-to-demux part of the latency, from the receiver's own counters.
+    const TransportPerfCounters& received =
+        pair.receiver()->receive_perf_counters();
+    state.counters["read_to_demux_p99_us"] =
+        static_cast<double>(received.latency_us.Percentile(99));
+  }
+}
+BENCHMARK(BM_LoopbackSrtp)
+    ->ArgNames({"size", "burst"})
+    ->ArgsProduct({{200, 1200}, {1, 8, 32}});
+
+}  // namespace
+}  // namespace libp2p_peerconnection
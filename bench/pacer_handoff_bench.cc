@@ -0,0 +1,258 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+// Packets per second per core of the pacer-to-network-thread handoff. The
+// benchmark thread plays the pacer and hands RTP bursts to a real network
+// thread, which protects them with SRTP and writes them to a loopback
+// DTLS-SRTP pair whose receiving end counts them.
+//
+// BM_PacerHandoffBurst goes through transport_controller::send_rtp_packets()
+// with buffers from AcquireRtpSendBuffers(), as the pacer and the video
+// packetizer do now. BM_PacerHandoffPostPerPacket is the path it replaced:
+// each packet copied into a fresh 2048 byte buffer and sent from its own
+// network-thread task.
+//
+// CPU time is measured for the whole process, so packets_per_core_second
+// covers the pacer and network thread together.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "libp2p_peerconnection/bench/bench_rtp_packet.h"
+#include "libp2p_peerconnection/bench/loopback_dtls_srtp_pair.h"
+#include "libp2p_peerconnection/connection_context.h"
+#include "libp2p_peerconnection/ctransport_controller.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
+
+namespace libp2p_peerconnection {
+namespace {
+
+constexpr uint32_t kSsrc = 0x0badcafe;
+constexpr char kMid[] = "video";
+constexpr size_t kPacketSize = 1200;
+constexpr int kHandshakeTimeoutMs = 5000;
+constexpr int kDrainTimeoutMs = 5000;
+// Packets the pacer may be ahead of the network thread before it waits.
+constexpr int64_t kMaxPacketsInFlight = 256;
+// Buffer size of the old per-packet send_rtp_packet().
+constexpr size_t kOldSendBufferCapacity = 2048;
+
+class CountingSink : public webrtc::RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const webrtc::RtpPacketReceived& packet) override {
+    packets_.fetch_add(1, std::memory_order_release);
+  }
+  int64_t packets() const { return packets_.load(std::memory_order_acquire); }
+
+ private:
+  std::atomic<int64_t> packets_{0};
+};
+
+// The connection context's network thread with a transport controller and
+// a connected loopback pair on it.
+class PacerHandoffFixture {
+ public:
+  bool Init() {
+    context_ = ConnectionContext::Create();
+    network_thread_ = context_->network_thread();
+    network_thread_->Invoke<void>(RTC_FROM_HERE, [this] {
+      controller_ = std::make_unique<transport_controller>(
+          network_thread_, context_->signaling_thread(),
+          context_->default_network_manager(),
+          context_->default_socket_factory());
+      pair_ = std::make_unique<LoopbackDtlsSrtpPair>(
+          libmedia_transfer_protocol::CryptoOptions());
+      pair_->StartHandshake();
+    });
+    const int64_t deadline_ms = rtc::TimeMillis() + kHandshakeTimeoutMs;
+    while (!network_thread_->Invoke<bool>(
+        RTC_FROM_HERE, [this] { return pair_->FinishHandshake(); })) {
+      if (rtc::TimeMillis() >= deadline_ms) {
+        return false;
+      }
+      rtc::Thread::SleepMs(5);
+    }
+    return network_thread_->Invoke<bool>(RTC_FROM_HERE, [this] {
+      // Bound like a negotiated mid, so the flush accepts its packets.
+      transport_generation_ =
+          controller_->BindRtpTransport_n(kMid, pair_->sender());
+      webrtc::RtpDemuxerCriteria criteria;
+      criteria.ssrcs.insert(kSsrc);
+      return pair_->receiver()->RegisterRtpDemuxerSink(criteria, &sink_);
+    });
+  }
+
+  ~PacerHandoffFixture() {
+    if (!network_thread_) {
+      return;
+    }
+    network_thread_->Invoke<void>(RTC_FROM_HERE, [this] {
+      if (pair_) {
+        controller_->BindRtpTransport_n(kMid, nullptr);
+        pair_->receiver()->UnregisterRtpDemuxerSink(&sink_);
+      }
+      controller_.reset();
+      pair_.reset();
+    });
+  }
+
+  // Keeps the pacer at most kMaxPacketsInFlight ahead of the receiver.
+  void WaitForInFlight(int64_t sent) const {
+    while (sent - sink_.packets() > kMaxPacketsInFlight) {
+      std::this_thread::yield();
+    }
+  }
+
+  bool WaitForAll(int64_t sent) const {
+    const int64_t deadline_ms = rtc::TimeMillis() + kDrainTimeoutMs;
+    while (sink_.packets() < sent) {
+      if (rtc::TimeMillis() >= deadline_ms) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  rtc::Thread* network_thread() { return network_thread_; }
+  transport_controller* controller() { return controller_.get(); }
+  // Only used as the bound transport of queued packets off the network
+  // thread, like the pointer p2p_peer_connection keeps.
+  RtpTransportInternal* sender() { return pair_->sender(); }
+  // What SignalRtpTransportChanged handed out for sender().
+  uint32_t transport_generation() const { return transport_generation_; }
+
+ private:
+  rtc::scoped_refptr<ConnectionContext> context_;
+  rtc::Thread* network_thread_ = nullptr;
+  std::unique_ptr<transport_controller> controller_;
+  std::unique_ptr<LoopbackDtlsSrtpPair> pair_;
+  uint32_t transport_generation_ = 0;
+  CountingSink sink_;
+};
+
+void ReportHandoff(benchmark::State& state, int64_t sent) {
+  state.SetItemsProcessed(sent);
+  state.SetBytesProcessed(sent * static_cast<int64_t>(kPacketSize));
+  // A rate counter divides by the measured CPU time, here the process's.
+  state.counters["packets_per_core_second"] =
+      benchmark::Counter(static_cast<double>(sent), benchmark::Counter::kIsRate);
+}
+
+// Arg: packets per pacer burst.
+void BM_PacerHandoffBurst(benchmark::State& state) {
+  const size_t burst_size = static_cast<size_t>(state.range(0));
+  PacerHandoffFixture fixture;
+  if (!fixture.Init()) {
+    state.SkipWithError("DTLS handshake did not finish");
+    return;
+  }
+  transport_controller* controller = fixture.controller();
+  RtpTransportInternal* rtp_transport = fixture.sender();
+  const uint32_t generation = fixture.transport_generation();
+  const std::vector<uint8_t> template_packet(kPacketSize, 0xab);
+  std::vector<rtc::CopyOnWriteBuffer> buffers;
+  std::vector<transport_controller::OutgoingRtpPacket> burst;
+  uint16_t sequence_number = 0;
+  uint32_t timestamp = 0;
+  int64_t sent = 0;
+
+  for (auto _ : state) {
+    buffers.clear();
+    controller->AcquireRtpSendBuffers(template_packet.data(),
+                                      template_packet.size(),
+                                      kRtpPacketBufferCapacity, burst_size,
+                                      &buffers);
+    for (rtc::CopyOnWriteBuffer& buffer : buffers) {
+      WriteBenchRtpHeader(&buffer, sequence_number++, timestamp, kSsrc);
+      burst.push_back({rtp_transport, generation, std::move(buffer), 0});
+    }
+    timestamp += 3000;
+    controller->send_rtp_packets(&burst);
+    sent += static_cast<int64_t>(burst_size);
+    fixture.WaitForInFlight(sent);
+  }
+  if (!fixture.WaitForAll(sent)) {
+    state.SkipWithError("packets were lost");
+    return;
+  }
+  ReportHandoff(state, sent);
+}
+
+// Arg: packets per pacer burst, all of them posted one by one.
+void BM_PacerHandoffPostPerPacket(benchmark::State& state) {
+  const size_t burst_size = static_cast<size_t>(state.range(0));
+  PacerHandoffFixture fixture;
+  if (!fixture.Init()) {
+    state.SkipWithError("DTLS handshake did not finish");
+    return;
+  }
+  rtc::Thread* network_thread = fixture.network_thread();
+  RtpTransportInternal* rtp_transport = fixture.sender();
+  std::vector<uint8_t> packet_data(kPacketSize, 0xab);
+  uint16_t sequence_number = 0;
+  uint32_t timestamp = 0;
+  int64_t sent = 0;
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < burst_size; ++i) {
+      rtc::CopyOnWriteBuffer packet(packet_data.data(), packet_data.size(),
+                                    kOldSendBufferCapacity);
+      WriteBenchRtpHeader(&packet, sequence_number++, timestamp, kSsrc);
+      network_thread->PostTask(webrtc::ToQueuedTask(
+          [rtp_transport, packet = std::move(packet)]() mutable {
+            rtp_transport->SendRtpPacket(&packet, rtc::PacketOptions(), 1);
+          }));
+    }
+    timestamp += 3000;
+    sent += static_cast<int64_t>(burst_size);
+    fixture.WaitForInFlight(sent);
+  }
+  if (!fixture.WaitForAll(sent)) {
+    state.SkipWithError("packets were lost");
+    return;
+  }
+  ReportHandoff(state, sent);
+}
+
+BENCHMARK(BM_PacerHandoffBurst)
+    ->ArgName("burst")
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(32)
+    ->MeasureProcessCPUTime();
+BENCHMARK(BM_PacerHandoffPostPerPacket)
+    ->ArgName("burst")
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(32)
+    ->MeasureProcessCPUTime();
+
+}  // namespace
+}  // namespace libp2p_peerconnection
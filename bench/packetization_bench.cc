@@ -0,0 +1,217 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+// Cost of packetizing one H.264 key frame of 50 KB, 200 KB and 1 MB the way
+// p2p_peer_connection::SendVideoEncode does it: header and extensions written
+// once into a template packet, buffers taken from a PacketBufferPool with the
+// template header already in place, the packetizer writing straight into
+// them. BM_PacketizeH264FrameCopied is the old loop for comparison, a
+// shared_ptr packet per RTP packet copied into the unique_ptr that is queued.
+//
+// Sent buffers go back to the pool after each frame, as the network thread
+// does after the socket write, so allocations_per_frame counts the buffers
+// the pool had to allocate.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "api/array_view.h"
+#include "benchmark/benchmark.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtp_format.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtp_header_extension_map.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtp_packet_to_send.h"
+#include "libp2p_peerconnection/bench/bench_rtp_packet.h"
+#include "libp2p_peerconnection/packet_buffer_pool.h"
+#include "modules/video_coding/codecs/h264/include/h264_globals.h"
+
+namespace libp2p_peerconnection {
+namespace {
+
+constexpr uint32_t kSsrc = 0x99aabbcc;
+constexpr int kTransportSequenceNumberId = 3;
+// Same packet size budget as SendVideoEncode without FEC.
+constexpr size_t kMaxRtpPacketSize = 1200;
+constexpr size_t kSendBufferCapacity = PacketBufferPool::kLargeBufferCapacity;
+
+// Annex B key frame: SPS, PPS and one IDR slice filling up to `size` bytes.
+// Slice bytes are kept above 0x03 so no start code shows up in the middle.
+std::vector<uint8_t> MakeH264KeyFrame(size_t size) {
+  static const uint8_t kSpsPps[] = {0, 0, 0, 1, 0x67, 0x42, 0xc0, 0x1f, 0xda,
+                                    0x01, 0x40, 0x16, 0xe8, 0x06, 0xd0, 0xa1,
+                                    0x35, 0,    0,    0,    1,    0x68, 0xce,
+                                    0x06, 0xe2};
+  static const uint8_t kIdrStart[] = {0, 0, 0, 1, 0x65};
+  std::vector<uint8_t> frame(kSpsPps, kSpsPps + sizeof(kSpsPps));
+  frame.insert(frame.end(), kIdrStart, kIdrStart + sizeof(kIdrStart));
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> slice_byte(0x04, 0xff);
+  while (frame.size() < size) {
+    frame.push_back(static_cast<uint8_t>(slice_byte(random)));
+  }
+  return frame;
+}
+
+class H264FrameBench {
+ public:
+  explicit H264FrameBench(size_t frame_size)
+      : frame_(MakeH264KeyFrame(frame_size)) {
+    extension_map_.Register<libmedia_transfer_protocol::TransportSequenceNumber>(
+        kTransportSequenceNumberId);
+    webrtc::RTPVideoHeaderH264 h264;
+    h264.packetization_mode = webrtc::H264PacketizationMode::NonInterleaved;
+    video_header_.video_type_header = h264;
+  }
+
+  libmedia_transfer_protocol::RtpPacketToSend MakeTemplatePacket() {
+    libmedia_transfer_protocol::RtpPacketToSend packet(&extension_map_,
+                                                       kSendBufferCapacity);
+    packet.SetPayloadType(kBenchRtpPayloadType);
+    packet.SetTimestamp(timestamp_);
+    packet.SetSsrc(kSsrc);
+    packet.ReserveExtension<libmedia_transfer_protocol::TransportSequenceNumber>();
+    packet.set_packet_type(libmedia_transfer_protocol::RtpPacketMediaType::kVideo);
+    timestamp_ += 3000;
+    return packet;
+  }
+
+  std::unique_ptr<libmedia_transfer_protocol::RtpPacketizer> MakePacketizer(
+      size_t headers_size) {
+    libmedia_transfer_protocol::RtpPacketizer::PayloadSizeLimits limits;
+    limits.max_payload_len = static_cast<int>(kMaxRtpPacketSize - headers_size);
+    return libmedia_transfer_protocol::RtpPacketizer::Create(
+        libmedia_codec::kVideoCodecH264,
+        rtc::ArrayView<const uint8_t>(frame_.data(), frame_.size()), limits,
+        video_header_);
+  }
+
+  uint16_t NextSequenceNumber() { return sequence_number_++; }
+
+ private:
+  const std::vector<uint8_t> frame_;
+  libmedia_transfer_protocol::RtpHeaderExtensionMap extension_map_;
+  libmedia_transfer_protocol::RTPVideoHeader video_header_;
+  uint32_t timestamp_ = 0;
+  uint16_t sequence_number_ = 0;
+};
+
+using PacketVector =
+    std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>>;
+
+void ReportFrames(benchmark::State& state, size_t packets_per_frame) {
+  const int64_t frames = static_cast<int64_t>(state.iterations());
+  state.SetItemsProcessed(frames);
+  state.SetBytesProcessed(frames * state.range(0));
+  state.counters["packets_per_frame"] = static_cast<double>(packets_per_frame);
+  // Printed as seconds per packet.
+  state.counters["time_per_packet"] = benchmark::Counter(
+      static_cast<double>(frames * packets_per_frame),
+      benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// Arg: frame size in bytes.
+void BM_PacketizeH264Frame(benchmark::State& state) {
+  H264FrameBench bench(static_cast<size_t>(state.range(0)));
+  PacketBufferPool pool;
+  std::vector<rtc::CopyOnWriteBuffer> buffers;
+  PacketVector packets;
+  size_t packets_per_frame = 0;
+
+  for (auto _ : state) {
+    libmedia_transfer_protocol::RtpPacketToSend template_packet =
+        bench.MakeTemplatePacket();
+    auto packetizer = bench.MakePacketizer(template_packet.headers_size());
+    const size_t num_packets = packetizer->NumPackets();
+    packets.reserve(num_packets);
+    buffers.clear();
+    for (size_t i = 0; i < num_packets; ++i) {
+      buffers.push_back(pool.Acquire(template_packet.data(),
+                                     template_packet.size(),
+                                     kSendBufferCapacity));
+    }
+    for (size_t i = 0; i < num_packets; ++i) {
+      auto packet = std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(
+          template_packet);
+      packet->Parse(std::move(buffers[i]));
+      if (!packetizer->NextPacket(packet.get())) {
+        break;
+      }
+      packet->SetSequenceNumber(bench.NextSequenceNumber());
+      packets.push_back(std::move(packet));
+    }
+    packets_per_frame = packets.size();
+    // What the pacer and the network thread do once the packets are sent.
+    for (auto& packet : packets) {
+      rtc::CopyOnWriteBuffer buffer = packet->Buffer();
+      packet.reset();
+      pool.Release(std::move(buffer));
+    }
+    packets.clear();
+  }
+  ReportFrames(state, packets_per_frame);
+  state.counters["allocations_per_frame"] =
+      static_cast<double>(pool.stats().misses) / state.iterations();
+}
+
+// The loop SendVideoEncode had before: a fresh shared_ptr packet per RTP
+// packet, copied into the unique_ptr that is queued.
+void BM_PacketizeH264FrameCopied(benchmark::State& state) {
+  H264FrameBench bench(static_cast<size_t>(state.range(0)));
+  PacketVector packets;
+  size_t packets_per_frame = 0;
+
+  for (auto _ : state) {
+    libmedia_transfer_protocol::RtpPacketToSend template_packet =
+        bench.MakeTemplatePacket();
+    auto packetizer = bench.MakePacketizer(template_packet.headers_size());
+    const size_t num_packets = packetizer->NumPackets();
+    for (size_t i = 0; i < num_packets; ++i) {
+      auto single_packet =
+          std::make_shared<libmedia_transfer_protocol::RtpPacketToSend>(
+              template_packet);
+      if (!packetizer->NextPacket(single_packet.get())) {
+        break;
+      }
+      single_packet->SetSequenceNumber(bench.NextSequenceNumber());
+      packets.push_back(
+          std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(
+              *single_packet));
+    }
+    packets_per_frame = packets.size();
+    packets.clear();
+  }
+  ReportFrames(state, packets_per_frame);
+}
+
+BENCHMARK(BM_PacketizeH264Frame)
+    ->ArgName("frame_bytes")
+    ->Arg(50 * 1024)
+    ->Arg(200 * 1024)
+    ->Arg(1024 * 1024);
+BENCHMARK(BM_PacketizeH264FrameCopied)
+    ->ArgName("frame_bytes")
+    ->Arg(50 * 1024)
+    ->Arg(200 * 1024)
+    ->Arg(1024 * 1024);
+
+}  // namespace
+}  // namespace libp2p_peerconnection
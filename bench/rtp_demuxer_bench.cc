@@ -0,0 +1,138 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+// Per-packet demux cost of FlatRtpDemuxer against webrtc::RtpDemuxer, which
+// it replaced in RtpTransport, with 1, 10 and 1000 SSRC-registered sinks.
+// Packets arrive interleaved across all streams in a fixed random order, so
+// with many streams the lookup does not stay on one hot table entry.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "call/rtp_demuxer.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "libp2p_peerconnection/bench/bench_rtp_packet.h"
+#include "libp2p_peerconnection/flat_rtp_demuxer.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+
+namespace libp2p_peerconnection {
+namespace {
+
+constexpr uint32_t kFirstSsrc = 0x10000000;
+constexpr size_t kPacketsPerStream = 16;
+constexpr size_t kMinPackets = 1024;
+
+class CountingSink : public webrtc::RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const webrtc::RtpPacketReceived& packet) override {
+    ++packets_;
+  }
+  int64_t packets() const { return packets_; }
+
+ private:
+  int64_t packets_ = 0;
+};
+
+// One sink per SSRC and a shuffled packet sequence covering every stream.
+struct DemuxerBenchStreams {
+  explicit DemuxerBenchStreams(size_t num_ssrcs) : sinks(num_ssrcs) {
+    const size_t num_packets =
+        std::max(kMinPackets, num_ssrcs * kPacketsPerStream);
+    packets.reserve(num_packets);
+    for (size_t i = 0; i < num_packets; ++i) {
+      webrtc::RtpPacketReceived packet;
+      packet.SetPayloadType(kBenchRtpPayloadType);
+      packet.SetSequenceNumber(static_cast<uint16_t>(i));
+      packet.SetSsrc(Ssrc(i % num_ssrcs));
+      packets.push_back(std::move(packet));
+    }
+    std::shuffle(packets.begin(), packets.end(), std::mt19937(42));
+  }
+
+  static uint32_t Ssrc(size_t index) {
+    // Spread like random SSRCs would be, not in one dense run.
+    return kFirstSsrc + static_cast<uint32_t>(index) * 7919u;
+  }
+
+  template <typename Demuxer>
+  bool Register(Demuxer* demuxer) {
+    for (size_t i = 0; i < sinks.size(); ++i) {
+      webrtc::RtpDemuxerCriteria criteria;
+      criteria.ssrcs.insert(Ssrc(i));
+      if (!demuxer->AddSink(criteria, &sinks[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int64_t delivered() const {
+    int64_t total = 0;
+    for (const CountingSink& sink : sinks) {
+      total += sink.packets();
+    }
+    return total;
+  }
+
+  std::vector<CountingSink> sinks;
+  std::vector<webrtc::RtpPacketReceived> packets;
+};
+
+template <typename Demuxer>
+void RunDemuxerBench(benchmark::State& state) {
+  DemuxerBenchStreams streams(static_cast<size_t>(state.range(0)));
+  Demuxer demuxer;
+  if (!streams.Register(&demuxer)) {
+    state.SkipWithError("failed to register the sinks");
+    return;
+  }
+  size_t next = 0;
+  for (auto _ : state) {
+    bool delivered = demuxer.OnRtpPacket(streams.packets[next]);
+    benchmark::DoNotOptimize(delivered);
+    if (++next == streams.packets.size()) {
+      next = 0;
+    }
+  }
+  if (streams.delivered() != static_cast<int64_t>(state.iterations())) {
+    state.SkipWithError("packets were not delivered");
+    return;
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// Arg: number of SSRCs.
+void BM_FlatRtpDemuxer(benchmark::State& state) {
+  RunDemuxerBench<FlatRtpDemuxer>(state);
+}
+void BM_WebrtcRtpDemuxer(benchmark::State& state) {
+  RunDemuxerBench<webrtc::RtpDemuxer>(state);
+}
+
+BENCHMARK(BM_FlatRtpDemuxer)->ArgName("ssrcs")->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK(BM_WebrtcRtpDemuxer)->ArgName("ssrcs")->Arg(1)->Arg(10)->Arg(1000);
+
+}  // namespace
+}  // namespace libp2p_peerconnection
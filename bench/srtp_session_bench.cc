@@ -0,0 +1,228 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+// SrtpSession protect/unprotect cost per crypto suite and burst size, with
+// ProtectRtpBatch() against one ProtectRtp() call per packet. The label of
+// each run names the suite and the AEAD backend that was installed.
+// BM_SrtpSessionCreate measures session setup and teardown from several
+// threads at once, the mass-reconnect case.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "api/array_view.h"
+#include "benchmark/benchmark.h"
+#include "libp2p_peerconnection/bench/bench_rtp_packet.h"
+#include "libp2p_peerconnection/packet_buffer_pool.h"
+#include "libp2p_peerconnection/srtp_crypto_backend.h"
+#include "libp2p_peerconnection/srtp_session.h"
+#include "rtc_base/ssl_stream_adapter.h"
+
+namespace libp2p_peerconnection {
+namespace {
+
+constexpr uint32_t kSsrc = 0x55667788;
+constexpr size_t kPayloadSize = 1200;
+constexpr int kPacketSize = static_cast<int>(kBenchRtpHeaderSize + kPayloadSize);
+constexpr int kPacketCapacity =
+    kPacketSize + static_cast<int>(PacketBufferPool::kTrailerHeadroom);
+
+// A send and a receive session keyed for `crypto_suite`, plus a burst of
+// RTP packets with room for the SRTP trailer.
+class SrtpBenchSessions {
+ public:
+  SrtpBenchSessions(int crypto_suite, size_t burst_size)
+      : storage_(burst_size * kPacketCapacity, 0xab),
+        refs_(burst_size),
+        results_(burst_size) {
+    int key_len = 0;
+    int salt_len = 0;
+    if (!rtc::GetSrtpKeyAndSaltLengths(crypto_suite, &key_len, &salt_len)) {
+      return;
+    }
+    std::vector<uint8_t> key(key_len + salt_len);
+    for (size_t i = 0; i < key.size(); ++i) {
+      key[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+    ready_ = send_.SetSend(crypto_suite, key.data(), key.size(), {}) &&
+             recv_.SetRecv(crypto_suite, key.data(), key.size(), {});
+  }
+
+  bool ready() const { return ready_; }
+  SrtpSession& send() { return send_; }
+  SrtpSession& recv() { return recv_; }
+
+  // Rewrites the RTP headers of the burst with the next sequence numbers,
+  // since protecting encrypted the previous ones in place.
+  rtc::ArrayView<SrtpSession::PacketRef> NextBurst() {
+    for (size_t i = 0; i < refs_.size(); ++i) {
+      uint8_t* data = &storage_[i * kPacketCapacity];
+      WriteBenchRtpHeader(data, sequence_number_++, timestamp_, kSsrc);
+      refs_[i].data = data;
+      refs_[i].len = kPacketSize;
+      refs_[i].max_len = kPacketCapacity;
+    }
+    timestamp_ += 3000;
+    return refs_;
+  }
+
+  rtc::ArrayView<int> results() { return results_; }
+
+ private:
+  SrtpSession send_;
+  SrtpSession recv_;
+  std::vector<uint8_t> storage_;
+  std::vector<SrtpSession::PacketRef> refs_;
+  std::vector<int> results_;
+  uint16_t sequence_number_ = 0;
+  uint32_t timestamp_ = 0;
+  bool ready_ = false;
+};
+
+void ReportPackets(benchmark::State& state, int crypto_suite, size_t burst_size) {
+  const int64_t packets = static_cast<int64_t>(state.iterations() * burst_size);
+  state.SetItemsProcessed(packets);
+  state.SetBytesProcessed(packets * kPacketSize);
+  state.SetLabel(rtc::SrtpCryptoSuiteToName(crypto_suite) + " " +
+                 SrtpCryptoBackendToString(GetSrtpCryptoBackend()));
+}
+
+// Args: crypto suite, packets per burst.
+void BM_SrtpProtectBatch(benchmark::State& state) {
+  const int crypto_suite = static_cast<int>(state.range(0));
+  const size_t burst_size = static_cast<size_t>(state.range(1));
+  SrtpBenchSessions sessions(crypto_suite, burst_size);
+  if (!sessions.ready()) {
+    state.SkipWithError("failed to set the SRTP keys");
+    return;
+  }
+  for (auto _ : state) {
+    const size_t protected_packets =
+        sessions.send().ProtectRtpBatch(sessions.NextBurst(), sessions.results());
+    benchmark::DoNotOptimize(protected_packets);
+  }
+  ReportPackets(state, crypto_suite, burst_size);
+}
+
+// The same burst through one ProtectRtp() call per packet.
+void BM_SrtpProtectPerPacket(benchmark::State& state) {
+  const int crypto_suite = static_cast<int>(state.range(0));
+  const size_t burst_size = static_cast<size_t>(state.range(1));
+  SrtpBenchSessions sessions(crypto_suite, burst_size);
+  if (!sessions.ready()) {
+    state.SkipWithError("failed to set the SRTP keys");
+    return;
+  }
+  for (auto _ : state) {
+    for (SrtpSession::PacketRef& packet : sessions.NextBurst()) {
+      int out_len = 0;
+      bool ok = sessions.send().ProtectRtp(packet.data, packet.len,
+                                           packet.max_len, &out_len);
+      benchmark::DoNotOptimize(ok);
+    }
+  }
+  ReportPackets(state, crypto_suite, burst_size);
+}
+
+// Protect and unprotect of a burst, both batched; the unprotect cost is the
+// difference to BM_SrtpProtectBatch.
+void BM_SrtpRoundTripBatch(benchmark::State& state) {
+  const int crypto_suite = static_cast<int>(state.range(0));
+  const size_t burst_size = static_cast<size_t>(state.range(1));
+  SrtpBenchSessions sessions(crypto_suite, burst_size);
+  if (!sessions.ready()) {
+    state.SkipWithError("failed to set the SRTP keys");
+    return;
+  }
+  for (auto _ : state) {
+    rtc::ArrayView<SrtpSession::PacketRef> burst = sessions.NextBurst();
+    sessions.send().ProtectRtpBatch(burst, sessions.results());
+    const size_t unprotected =
+        sessions.recv().UnprotectRtpBatch(burst, sessions.results());
+    if (unprotected != burst_size) {
+      state.SkipWithError("unprotect failed");
+      return;
+    }
+  }
+  ReportPackets(state, crypto_suite, burst_size);
+}
+
+void SrtpBenchArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"suite", "burst"})
+      ->ArgsProduct({{rtc::SRTP_AES128_CM_SHA1_80, rtc::SRTP_AEAD_AES_128_GCM},
+                     {1, 8, 32}});
+}
+
+BENCHMARK(BM_SrtpProtectBatch)->Apply(SrtpBenchArgs);
+BENCHMARK(BM_SrtpProtectPerPacket)->Apply(SrtpBenchArgs);
+BENCHMARK(BM_SrtpRoundTripBatch)->Apply(SrtpBenchArgs);
+
+constexpr size_t kSessionsPerIteration = 1000;
+
+// Every thread creates kSessionsPerIteration sessions per iteration, keys
+// half of them for sending and half for receiving, then destroys them all.
+// With no process-wide lock on this path, sessions_per_second should grow
+// with the number of threads up to the number of cores.
+void BM_SrtpSessionCreate(benchmark::State& state) {
+  const int crypto_suite = rtc::SRTP_AES128_CM_SHA1_80;
+  int key_len = 0;
+  int salt_len = 0;
+  if (!rtc::GetSrtpKeyAndSaltLengths(crypto_suite, &key_len, &salt_len)) {
+    state.SkipWithError("unknown crypto suite");
+    return;
+  }
+  std::vector<uint8_t> key(key_len + salt_len);
+  for (size_t i = 0; i < key.size(); ++i) {
+    key[i] = static_cast<uint8_t>(i * 13 + 5);
+  }
+  std::vector<std::unique_ptr<SrtpSession>> sessions;
+  sessions.reserve(kSessionsPerIteration);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < kSessionsPerIteration; ++i) {
+      auto session = std::make_unique<SrtpSession>();
+      const bool ok =
+          (i % 2 == 0)
+              ? session->SetSend(crypto_suite, key.data(), key.size(), {})
+              : session->SetRecv(crypto_suite, key.data(), key.size(), {});
+      if (!ok) {
+        state.SkipWithError("failed to set the SRTP keys");
+        return;
+      }
+      sessions.push_back(std::move(session));
+    }
+    sessions.clear();
+  }
+  state.counters["sessions_per_second"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * kSessionsPerIteration),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SrtpSessionCreate)
+    ->ThreadRange(1, static_cast<int>(
+                         std::max(1u, std::thread::hardware_concurrency())))
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace libp2p_peerconnection
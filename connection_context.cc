@@ -26,6 +26,7 @@
 
 #include "api/transport/field_trial_based_config.h"
 #include "libmedia_transfer_protocol/sctp/sctp_transport_factory.h"
+#include "libp2p_peerconnection/batched_packet_socket_factory.h"
 #include "rtc_base/helpers.h"
 #include "rtc_base/task_utils/to_queued_task.h"
 #include "rtc_base/time_utils.h"
@@ -103,7 +104,7 @@ ConnectionContext::ConnectionContext()
 		// always is injected (with no need to construct this default factory), or get
 		// the appropriate underlying SocketFactory without going through the
 		// rtc::Thread::socketserver() accessor.
-		default_socket_factory_ = std::make_unique<libice::BasicPacketSocketFactory>(
+		default_socket_factory_ = std::make_unique<BatchedPacketSocketFactory>(
 			network_thread()->socketserver());
 	}
 	else
@@ -122,7 +123,7 @@ ConnectionContext::ConnectionContext()
 			// always is injected (with no need to construct this default factory), or get
 			// the appropriate underlying SocketFactory without going through the
 			// rtc::Thread::socketserver() accessor.
-			default_socket_factory_ = std::make_unique<libice::BasicPacketSocketFactory>(
+			default_socket_factory_ = std::make_unique<BatchedPacketSocketFactory>(
 				network_thread()->socketserver());
 
 		});
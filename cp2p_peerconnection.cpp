@@ -17,6 +17,7 @@
 
  ******************************************************************************/
 #include "libp2p_peerconnection/cp2p_peerconnection.h"
+#include <algorithm>
 #include "api/jsep.h"
 #include "pc/webrtc_sdp.h"
 #include "libice/candidate.h"
@@ -25,15 +26,174 @@
 #include "libmedia_transfer_protocol/rtp_rtcp/rtp_packet_to_send.h"
 #include "libmedia_transfer_protocol/rtp_rtcp/rtp_format.h"
 #include "modules/video_coding/codecs/h264/include/h264_globals.h"
+#include "modules/video_coding/codecs/vp8/include/vp8_globals.h"
+#include "modules/video_coding/codecs/vp9/include/vp9_globals.h"
+#include "libmedia_transfer_protocol/media_constants.h"
+#include "absl/strings/match.h"
 #include "api/task_queue/default_task_queue_factory.h"
+#include "api/task_queue/task_queue_base.h"
 #include "libmedia_transfer_protocol/rtp_rtcp/rtp_rtcp_defines.h"
 #include "libice/network_types.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtcp_packet/common_header.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtcp_packet/fir.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtcp_packet/nack.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtcp_packet/pli.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtcp_packet/remb.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtcp_packet/transport_feedback.h"
+#include "rtc_base/byte_io.h"
+#include "rtc_base/task_utils/to_queued_task.h"
 //#include "libmedia_codec/builtin_video_bitrate_allocator_factory.h"
 //#include "libp2p_peerconnection/engine/webrtc_media_engine.h"
 namespace libp2p_peerconnection
 {
-	const size_t RTC_PACKET_CACHE_SIZE = 2048;
 	namespace {
+		// 视频包保存1s, 用于NACK重传
+		constexpr int kNackRtpHistoryMs = 1000;
+		// RTX payload前面的原始序号(OSN), RFC 4588
+		constexpr size_t kRtxHeaderSize = 2;
+		constexpr int kFlexfecPayloadType = 118;
+		// 纯padding包的最大padding长度(RTP padding长度字段只有1字节), 同webrtc
+		constexpr size_t kMaxPaddingLength = 224;
+		// 纯padding包只有RTP头+padding, 不需要按最大包长分配
+		constexpr size_t kPaddingPacketCapacity = 512;
+		// 音频包RTP头(含扩展)预留
+		constexpr size_t kAudioRtpHeaderReserve = 64;
+		// audio_encode_time_us_每个slot: 高16位RTP序号, 低48位编码完成时间(us)
+		constexpr int kEncodeTimeBits = 48;
+		constexpr uint64_t kEncodeTimeMask = (uint64_t{ 1 } << kEncodeTimeBits) - 1;
+		// 链路MTU
+		constexpr size_t kPathMtu = 1500;
+		// 还不知道选中的路径时按IPv6 + UDP + TURN ChannelData + SRTP估算
+		constexpr int kDefaultTransportOverhead = 40 + 8 + 4 + static_cast<int>(kSrtpMaxRtpTrailerLen);
+
+		static void AddH264Params(libmedia_transfer_protocol::VideoCodec* codec)
+		{
+			// a=fmtp:107 level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f
+			codec->params.insert(std::make_pair("level-asymmetry-allowed", "1"));
+			codec->params.insert(std::make_pair("packetization-mode", "1"));
+			codec->params.insert(std::make_pair("profile-level-id", "42e01f"));
+		}
+		static void AddVp9Params(libmedia_transfer_protocol::VideoCodec* codec)
+		{
+			// a=fmtp:98 profile-id=0
+			codec->params.insert(std::make_pair("profile-id", "0"));
+		}
+		static void FillH264Header(const libmedia_codec::EncodedImage& image, size_t num_spatial_layers,
+			bool end_of_picture, libmedia_transfer_protocol::RTPVideoHeader* header)
+		{
+			webrtc::RTPVideoHeaderH264  h;
+			// 与SDP中packetization-mode=1一致: 大NALU用FU-A分片, SPS/PPS/SEI等小NALU用STAP-A聚合
+			h.packetization_mode = webrtc::H264PacketizationMode::NonInterleaved;
+			header->video_type_header = h;
+		}
+		static void FillVp8Header(const libmedia_codec::EncodedImage& image, size_t num_spatial_layers,
+			bool end_of_picture, libmedia_transfer_protocol::RTPVideoHeader* header)
+		{
+			webrtc::RTPVideoHeaderVP8  vp8;
+			vp8.InitRTPVideoHeaderVP8();
+			vp8.nonReference = false;
+			header->video_type_header = vp8;
+		}
+		static void FillVp9Header(const libmedia_codec::EncodedImage& image, size_t num_spatial_layers,
+			bool end_of_picture, libmedia_transfer_protocol::RTPVideoHeader* header)
+		{
+			webrtc::RTPVideoHeaderVP9  vp9;
+			vp9.InitRTPVideoHeaderVP9();
+			const bool key_frame = image._frameType == libmedia_codec::VideoFrameType::kVideoFrameKey;
+			vp9.flexible_mode = false;
+			vp9.inter_pic_predicted = !key_frame;
+			vp9.beginning_of_frame = true;
+			vp9.end_of_frame = true;
+			// SVC: 编码器每个空间层输出一个EncodedImage, 层数和是否最高层由调用方给出,
+			// 只有最高层带end_of_picture(marker位)
+			vp9.num_spatial_layers = num_spatial_layers;
+			vp9.end_of_picture = end_of_picture;
+			if (image.SpatialIndex())
+			{
+				vp9.spatial_idx = static_cast<uint8_t>(*image.SpatialIndex());
+				vp9.inter_layer_predicted = vp9.spatial_idx > 0;
+				vp9.non_ref_for_inter_layer_pred = false;
+			}
+			header->video_type_header = vp9;
+		}
+
+		// 视频codec分发表, 顺序即offer中的优先级; AV1没有codec相关的header
+		struct VideoCodecEntry
+		{
+			const char*                      name;
+			libmedia_codec::VideoCodecType   type;
+			int                              payload_type;
+			int                              rtx_payload_type;
+			void (*add_params)(libmedia_transfer_protocol::VideoCodec* codec);
+			void (*fill_video_header)(const libmedia_codec::EncodedImage& image, size_t num_spatial_layers,
+				bool end_of_picture, libmedia_transfer_protocol::RTPVideoHeader* header);
+		};
+		static const VideoCodecEntry kVideoCodecs[] = {
+			{ libmedia_transfer_protocol::kH264CodecName, libmedia_codec::kVideoCodecH264, 107, 99, &AddH264Params, &FillH264Header },
+			{ libmedia_transfer_protocol::kVp8CodecName, libmedia_codec::kVideoCodecVP8, 96, 97, nullptr, &FillVp8Header },
+			{ libmedia_transfer_protocol::kVp9CodecName, libmedia_codec::kVideoCodecVP9, 98, 100, &AddVp9Params, &FillVp9Header },
+			{ libmedia_transfer_protocol::kAv1CodecName, libmedia_codec::kVideoCodecAV1, 45, 46, nullptr, nullptr },
+		};
+		static const VideoCodecEntry* FindVideoCodec(const std::string& name)
+		{
+			for (const VideoCodecEntry& entry : kVideoCodecs)
+			{
+				if (absl::EqualsIgnoreCase(name, entry.name))
+				{
+					return &entry;
+				}
+			}
+			return nullptr;
+		}
+		static const VideoCodecEntry* FindVideoCodec(libmedia_codec::VideoCodecType type)
+		{
+			for (const VideoCodecEntry& entry : kVideoCodecs)
+			{
+				if (entry.type == type)
+				{
+					return &entry;
+				}
+			}
+			return nullptr;
+		}
+		static void AddVideoFeedbackParams(libmedia_transfer_protocol::VideoCodec* codec)
+		{
+			/*
+				a=rtcp-fb:107 goog-remb
+				a=rtcp-fb:107 transport-cc
+				a=rtcp-fb:107 ccm fir
+				a=rtcp-fb:107 nack
+				a=rtcp-fb:107 nack pli
+			*/
+			libmedia_transfer_protocol::FeedbackParam feedbackparam;
+			feedbackparam.id_ = "goog-remb";
+			codec->feedback_params.Add(feedbackparam);
+			feedbackparam.id_ = "transport-cc";
+			codec->feedback_params.Add(feedbackparam);
+			feedbackparam.id_ = "ccm";
+			feedbackparam.param_ = "fir";
+			codec->feedback_params.Add(feedbackparam);
+			feedbackparam.id_ = "nack";
+			feedbackparam.param_ = "";
+			codec->feedback_params.Add(feedbackparam);
+			feedbackparam.id_ = "nack";
+			feedbackparam.param_ = "pli";
+			codec->feedback_params.Add(feedbackparam);
+		}
+		// a=extmap:<id>[/direction] <uri> [attributes]
+		static void ParseExtmap(const std::string& line, RtpHeaderExtensions* extensions)
+		{
+			const size_t uri_begin = line.find(' ');
+			if (uri_begin == std::string::npos)
+			{
+				RTC_LOG(LS_WARNING) << "parse extmap failed: " << line;
+				return;
+			}
+			const size_t uri_end = line.find(' ', uri_begin + 1);
+			const std::string uri = uri_end == std::string::npos
+				? line.substr(uri_begin + 1) : line.substr(uri_begin + 1, uri_end - uri_begin - 1);
+			extensions->emplace_back(uri, std::atoi(line.c_str() + 9));
+		}
 		// a=attr_name:attr_value
 		static std::string GetAttribute(const std::string& line) {
 			std::vector<std::string> fields;
@@ -45,7 +205,7 @@ namespace libp2p_peerconnection
 
 			return fields[1];
 		}
-		static bool ParseCandidates(MediaContentDescription* media_content,
+		static bool ParseCandidates(MediaContentDescription* media_content, const std::string & mid,
 			const std::string& line, std::vector< libice::Candidate> & all_c)
 		{
 			if (line.find("a=candidate:") == std::string::npos) {
@@ -71,6 +231,8 @@ namespace libp2p_peerconnection
 			uint16_t  port = std::atoi(fields[5].c_str());
 			c.set_address(  rtc::SocketAddress(fields[4], port));
 			c.set_type(  fields[7]);
+			// 不BUNDLE时按mid加到对应的ICE transport
+			c.set_transport_name(mid);
 			all_c.push_back(c);
 			//media_content->AddCandidate(c);
 			return true;
@@ -150,12 +312,12 @@ namespace libp2p_peerconnection
 		: context_(ConnectionContext::Create())
 		, transport_controller_(nullptr)
 		//, signaling_thread_safety_()
-		, video_cache_(RTC_PACKET_CACHE_SIZE)
 		, transport_send_(nullptr)
 		//, media_engine_(nullptr)
 		//, video_bitrate_allocator_factory_ (libmedia_codec::CreateBuiltinVideoBitrateAllocatorFactory())
 		, rtp_rtcp_impl_(nullptr)
 		, task_queue_factory_(webrtc::CreateDefaultTaskQueueFactory())
+		, video_transport_overhead_(kDefaultTransportOverhead)
 	{
 
 		if (context_->network_thread()->IsCurrent())
@@ -167,6 +329,8 @@ namespace libp2p_peerconnection
 			transport_controller_->SignalIceTransportStateChanged.connect(this, & p2p_peer_connection::IceTransportStateChanged_n);
 			transport_controller_->SignalRtcpPacketReceived.connect(
 				this, & p2p_peer_connection::OnRtcpPacketReceived_n);
+			transport_controller_->SignalRtpTransportChanged.connect(
+				this, &p2p_peer_connection::OnRtpTransportChanged_n);
 		}
 		else
 		{
@@ -180,6 +344,8 @@ namespace libp2p_peerconnection
 				transport_controller_->SignalIceTransportStateChanged.connect(this, & p2p_peer_connection::IceTransportStateChanged_n);
 				transport_controller_->SignalRtcpPacketReceived.connect(
 					this, & p2p_peer_connection::OnRtcpPacketReceived_n);
+				transport_controller_->SignalRtpTransportChanged.connect(
+					this, &p2p_peer_connection::OnRtpTransportChanged_n);
 			});
 			/*context_->signaling_thread()->Invoke<void>(RTC_FROM_HERE, [&]() {
 				RTC_DCHECK_RUN_ON(context_->signaling_thread());
@@ -213,6 +379,8 @@ namespace libp2p_peerconnection
 		context_->network_thread()->Invoke<void>(RTC_FROM_HERE, [this]() {
 			RTC_DCHECK_RUN_ON(context_->network_thread());
 			  transport_controller_.reset(nullptr);
+			  // NACK定时器在网络线程, 接收端也要在网络线程释放
+			  video_receiver_.reset();
 		});
 		context_->Release();
 		//context_->network_thread()->Stop();
@@ -254,6 +422,9 @@ namespace libp2p_peerconnection
 		ContentInfo  audio_content_info;
 		
 		ContentInfo video_content_info;
+		// 对端视频 payload type => codec名字, 以及 apt => rtx payload type
+		std::map<int, std::string> remote_video_codecs;
+		std::map<int, int> remote_video_rtx;
 		//remote_desc_->contents_.push_back(content_info);
 		for (auto field : fields) {
 			// 如果以\r\n换行，去掉尾部的\r
@@ -300,8 +471,10 @@ namespace libp2p_peerconnection
 			}
 			
 			if ("audio" == mid) {
-				
-				if (!ParseCandidates(audio_content.get(), field, all_candidate)) {
+				if (field.find("a=extmap:") == 0) {
+					ParseExtmap(field, &audio_content->rtp_header_extensions_);
+				}
+				if (!ParseCandidates(audio_content.get(), mid, field, all_candidate)) {
 					RTC_LOG(LS_WARNING) << "parse candidate failed: " << field;
 					return -1;
 				}
@@ -312,7 +485,26 @@ namespace libp2p_peerconnection
 				}
 			}
 			else if ("video" == mid) {
-				if (!ParseCandidates(video_content.get(), field, all_candidate)) {
+				if (field.find("a=extmap:") == 0) {
+					ParseExtmap(field, &video_content->rtp_header_extensions_);
+				}
+				// a=rtpmap:107 H264/90000
+				else if (field.find("a=rtpmap:") == 0) {
+					const size_t name_begin = field.find(' ');
+					const size_t name_end = field.find('/', name_begin);
+					if (name_begin != std::string::npos && name_end != std::string::npos) {
+						remote_video_codecs[std::atoi(field.c_str() + 9)] =
+							field.substr(name_begin + 1, name_end - name_begin - 1);
+					}
+				}
+				// a=fmtp:99 apt=107
+				else if (field.find("a=fmtp:") == 0) {
+					const size_t apt = field.find("apt=");
+					if (apt != std::string::npos) {
+						remote_video_rtx[std::atoi(field.c_str() + apt + 4)] = std::atoi(field.c_str() + 7);
+					}
+				}
+				if (!ParseCandidates(video_content.get(), mid, field, all_candidate)) {
 					RTC_LOG(LS_WARNING) << "parse candidate failed: " << field;
 					return -1;
 				}
@@ -335,6 +527,54 @@ namespace libp2p_peerconnection
 
 		
 
+		// answer中m=video的第一个payload type就是协商结果
+		for (const auto & pt_name : remote_video_codecs)
+		{
+			if (absl::EqualsIgnoreCase(pt_name.second, "flexfec-03"))
+			{
+				video_flexfec_pt_ = pt_name.first;
+			}
+		}
+		auto remote_codec = remote_video_codecs.find(video_pt_);
+		const VideoCodecEntry * video_codec = remote_codec != remote_video_codecs.end()
+			? FindVideoCodec(remote_codec->second) : nullptr;
+		if (video_codec)
+		{
+			video_codec_type_ = video_codec->type;
+			auto rtx = remote_video_rtx.find(video_pt_);
+			video_rtx_pt_ = rtx != remote_video_rtx.end() ? rtx->second : video_codec->rtx_payload_type;
+			RTC_LOG(LS_INFO) << "negotiated video codec: " << video_codec->name << ", pt: " << static_cast<int>(video_pt_)
+				<< ", rtx pt: " << static_cast<int>(video_rtx_pt_);
+		}
+		else if (video_pt_ != 0)
+		{
+			RTC_LOG(LS_WARNING) << "unsupported video payload type: " << static_cast<int>(video_pt_);
+		}
+		if (video_codec && video_codec_type_ == libmedia_codec::kVideoCodecH264 && !video_receiver_)
+		{
+			// 在网络线程创建, NACK定时器跑在网络线程
+			context_->network_thread()->Invoke<void>(RTC_FROM_HERE, [this]() {
+				video_receiver_ = std::make_unique<RtpVideoStreamReceiver>(context_->network_thread(),
+					context_->worker_thread(), video_pt_, video_rtx_pt_, [this](uint32_t media_ssrc) {
+					SendPli_n(media_ssrc);
+				}, [this](uint32_t media_ssrc, const std::vector<uint16_t>& sequence_numbers) {
+					SendNack_n(media_ssrc, sequence_numbers);
+				});
+			});
+			video_receiver_->SetBaseMinimumPlayoutDelayMs(base_minimum_playout_delay_ms_);
+			video_receiver_->SetLowLatencyMode(low_latency_mode_);
+			video_receiver_->SetSink(remote_video_sink_);
+		}
+		else if (video_codec && video_codec_type_ != libmedia_codec::kVideoCodecH264)
+		{
+			RTC_LOG(LS_WARNING) << "receiving video only supports H264, not " << video_codec->name;
+		}
+		if (video_flexfec_pt_ != 0 && local_video_flexfec_ssrc_ != 0 && !flexfec_sender_)
+		{
+			flexfec_sender_ = std::make_unique<FlexfecSender>(video_flexfec_pt_, local_video_flexfec_ssrc_,
+				local_video_ssrc_, &rtp_header_extension_map_);
+		}
+
 		transport_controller_->set_remote_sdp(remote_desc_.get());
 		for (const libice::Candidate & candidate:all_candidate)
 		{
@@ -374,6 +614,9 @@ namespace libp2p_peerconnection
 			//AudioContentDescription audio_content;
 			audio_content->direction_ = (GetDirection(options.send_audio, options.recv_audio));
 			audio_content->rtcp_mux_ = (options.use_rtcp_mux);
+			// a=extmap transport-cc, id同发送时注册的
+			audio_content->rtp_header_extensions_.emplace_back(libmedia_transfer_protocol::RtpExtension::kTransportSequenceNumberUri,
+				rtp_header_extension_map_.GetId(libmedia_transfer_protocol::kRtpExtensionTransportSequenceNumber));
 			
 			libice::TransportInfo  transport_info;
 			transport_info.content_name = "audio";
@@ -421,6 +664,8 @@ namespace libp2p_peerconnection
 			auto video_content = std::make_unique<VideoContentDescription>();
 			video_content->direction_ = (GetDirection(options.send_video, options.recv_video));
 			video_content->rtcp_mux_ = (options.use_rtcp_mux);
+			video_content->rtp_header_extensions_.emplace_back(libmedia_transfer_protocol::RtpExtension::kTransportSequenceNumberUri,
+				rtp_header_extension_map_.GetId(libmedia_transfer_protocol::kRtpExtensionTransportSequenceNumber));
 			libice::TransportInfo  transport_info;
 			transport_info.content_name = "video";
 			transport_info.description.identity_fingerprint = rtc::SSLFingerprint::CreateFromCertificate(*certificate_);
@@ -441,6 +686,7 @@ namespace libp2p_peerconnection
 				video_stream.cname = cname;
 				local_video_ssrc_ = rtc::CreateRandomId();
 				local_video_rtx_ssrc_ = rtc::CreateRandomId();
+				local_video_flexfec_ssrc_ = rtc::CreateRandomId();
 				video_stream.ssrcs.push_back(local_video_ssrc_);
 				//video_stream.ssrcs.push_back(local_video_rtx_ssrc_);
 				// 107
@@ -452,6 +698,11 @@ namespace libp2p_peerconnection
 				//sg.ssrcs.push_back(local_video_ssrc_);
 				//sg.ssrcs.push_back(local_video_rtx_ssrc_);
 				video_stream.ssrc_groups.push_back(sg);
+				// a=ssrc-group:FEC-FR media_ssrc flexfec_ssrc
+				libmedia_transfer_protocol::SsrcGroup fec_group;
+				fec_group.semantics = "FEC-FR";
+				fec_group.ssrcs = { local_video_ssrc_ , local_video_flexfec_ssrc_ };
+				video_stream.ssrc_groups.push_back(fec_group);
 
 				video_content->send_streams_.push_back(video_stream);
 
@@ -462,53 +713,56 @@ namespace libp2p_peerconnection
 				video_rtx_stream.cname = cname;
 				video_rtx_stream.ssrcs.push_back(local_video_rtx_ssrc_);
 				video_content->send_streams_.emplace_back(video_rtx_stream);
-				libmedia_transfer_protocol::VideoCodec video_codec;
-				video_codec.id =  107;
-				video_codec.name = "H264";
-				video_codec.clockrate = 90000;
-				// a=fmtp:107 level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f
 
-				video_codec.params.insert(std::make_pair("level-asymmetry-allowed", "1"));
-				video_codec.params.insert(std::make_pair("packetization-mode", "1"));
-				video_codec.params.insert(std::make_pair("profile-level-id", "42e01f"));
-				//video_codec.params.insert(std::make_pair(std::to_string(video_codec.id), "useinbandfec=1"));
+				// 创建flexfec stream
+				libmedia_transfer_protocol::StreamParams video_flexfec_stream;
+				video_flexfec_stream.id = id;
+				video_flexfec_stream.stream_ids_ = { stream_id };
+				video_flexfec_stream.cname = cname;
+				video_flexfec_stream.ssrcs.push_back(local_video_flexfec_ssrc_);
+				video_content->send_streams_.emplace_back(video_flexfec_stream);
+				// 每个codec后面跟它的rtx
+				for (const VideoCodecEntry & entry : kVideoCodecs)
+				{
+					libmedia_transfer_protocol::VideoCodec video_codec;
+					video_codec.id = entry.payload_type;
+					video_codec.name = entry.name;
+					video_codec.clockrate = 90000;
+					if (entry.add_params)
+					{
+						entry.add_params(&video_codec);
+					}
+					AddVideoFeedbackParams(&video_codec);
+
+					/*
+						a=rtpmap:99 rtx/90000
+						a=fmtp:99 apt=107
+					*/
+					libmedia_transfer_protocol::VideoCodec video_rtx_codec;
+					video_rtx_codec.id = entry.rtx_payload_type;
+					video_rtx_codec.name = "rtx";
+					video_rtx_codec.clockrate = 90000;
+					video_rtx_codec.params.insert(std::make_pair("apt", std::to_string(video_codec.id)));
+					video_content->codecs_.push_back(video_codec);
+					video_content->codecs_.push_back(video_rtx_codec);
+				}
+				// 收到answer之前按首选codec
+				video_codec_type_ = kVideoCodecs[0].type;
+				video_rtx_pt_ = kVideoCodecs[0].rtx_payload_type;
 
 				/*
-					a=rtpmap:107 H264/90000
-					a=rtcp-fb:107 goog-remb
-					a=rtcp-fb:107 transport-cc
-					a=rtcp-fb:107 ccm fir
-					a=rtcp-fb:107 nack
-					a=rtcp-fb:107 nack pli
-				*/
-				libmedia_transfer_protocol::FeedbackParam feedbackparam;
-				feedbackparam.id_ = "goog-remb";
-				//feedbackparam.param_ = "transport-cc";
-				video_codec.feedback_params.Add(feedbackparam);
-				feedbackparam.id_ = "transport-cc"; 
-				video_codec.feedback_params.Add(feedbackparam); 
-				feedbackparam.id_ = "ccm";
-				feedbackparam.param_ = "fir";
-				video_codec.feedback_params.Add(feedbackparam); 
-				feedbackparam.id_ = "nack";
-				feedbackparam.param_ = "";
-				video_codec.feedback_params.Add(feedbackparam); 
-				feedbackparam.id_ = "nack";
-				feedbackparam.param_ = "pli";
-				video_codec.feedback_params.Add(feedbackparam);  
-
-				libmedia_transfer_protocol::VideoCodec video_rtx_codec;
-				video_rtx_codec.id = 99;
-				video_rtx_codec.name = "rtx";
-				video_rtx_codec.clockrate = 90000;
-				/*
-					a=rtpmap:99 rtx/90000
-					a=fmtp:99 apt=107
+					a=rtpmap:118 flexfec-03/90000
+					a=fmtp:118 repair-window=10000000
 				*/
-				video_rtx_codec.id = 99;
-				video_rtx_codec.params.insert(std::make_pair("apt", std::to_string(video_codec.id)));
-				video_content->codecs_.push_back(video_codec);
-				video_content->codecs_.push_back(video_rtx_codec);
+				libmedia_transfer_protocol::VideoCodec video_flexfec_codec;
+				video_flexfec_codec.id = kFlexfecPayloadType;
+				video_flexfec_codec.name = "flexfec-03";
+				video_flexfec_codec.clockrate = 90000;
+				video_flexfec_codec.params.insert(std::make_pair("repair-window", "10000000"));
+				video_content->codecs_.push_back(video_flexfec_codec);
+				// 声明了nack, 发送端需要保存已发送的包
+				video_nack_config_.rtp_history_ms = kNackRtpHistoryMs;
+				video_history_ = std::make_unique<RtpPacketHistory>(video_nack_config_.rtp_history_ms);
 			//	CreateVideoSendStream(video_content.get());
 			}
 			content.description_ = (std::move(video_content));
@@ -519,9 +773,15 @@ namespace libp2p_peerconnection
 		if (options.use_rtp_mux) {
 			ContentGroup answer_bundle;// ("BUNDLE");
 			answer_bundle.semantics_ = "BUNDLE";
+			// answer只能BUNDLE对端offer里已经BUNDLE的mid, 其他mid各自一个transport(见transport_controller::set_remote_sdp)
+			const ContentGroup * offer_bundle = remote_desc_ ? remote_desc_->GetGroupByName("BUNDLE") : nullptr;
 			//for (auto content : local_desc_->contents())
 			for (size_t i = 0; i <  local_desc_->contents_.size(); ++i)
 			{
+				if (remote_desc_ && (!offer_bundle || !offer_bundle->HasContentName(local_desc_->contents_[i].name)))
+				{
+					continue;
+				}
 				answer_bundle.content_names_.emplace_back(local_desc_->contents_[i].name);
 				//answer_bundle.AddContentName(content.mid());
 			}
@@ -564,21 +824,303 @@ namespace libp2p_peerconnection
 			transport_send_->OnNetworkOk(ice_state);
 		}
 	}
+	// RTCP包类型200(SR)到207(XR)的跳转表, 下标为type - kRtcpFirstPacketType
+	const p2p_peer_connection::RtcpHandler p2p_peer_connection::kRtcpHandlers[kRtcpPacketTypes] = {
+		&p2p_peer_connection::OnRtcpReport_n,          // 200 SR
+		&p2p_peer_connection::OnRtcpReport_n,          // 201 RR
+		&p2p_peer_connection::OnRtcpReport_n,          // 202 SDES
+		&p2p_peer_connection::OnRtcpReport_n,          // 203 BYE
+		&p2p_peer_connection::OnRtcpApp_n,             // 204 APP
+		&p2p_peer_connection::OnRtpFeedback_n,         // 205 RTPFB
+		&p2p_peer_connection::OnPayloadFeedback_n,     // 206 PSFB
+		&p2p_peer_connection::OnRtcpReport_n,          // 207 XR
+	};
 	void p2p_peer_connection::OnRtcpPacketReceived_n(rtc::CopyOnWriteBuffer * packet, int64_t packet_time_us)
 	{
-		if (rtp_rtcp_impl_)
+		RTC_DCHECK_RUN_ON(context_->network_thread());
+		// compound RTCP在网络线程原地解析, 按类型查表分发: NACK, transport-cc, REMB直接处理, 不经过信令线程;
+		// 只有SR/RR/SDES/BYE/XR(RTT, 接收报告)需要rtp_rtcp_impl_, 拼成一个包投递到信令线程
+		// 开头连续的报告块共享原来的buffer, 遇到第一个不投递的块时才拷贝前面的报告块
+		rtc::CopyOnWriteBuffer report_packets;
+		bool copying = false;
+		const uint8_t * const begin = packet->cdata();
+		const uint8_t * const end = begin + packet->size();
+		const uint8_t * reports_end = begin;
+		const uint8_t * next = begin;
+		libmedia_transfer_protocol::rtcp::CommonHeader header;
+		for (; next < end; next = header.NextPacket())
 		{
-			//signalie_thread_->PostTask();
-			rtc::CopyOnWriteBuffer   bufer(*packet);
-			context_->signaling_thread()->PostTask(/*webrtc::ToQueuedTask(signaling_thread_safety_.flag(),*/RTC_FROM_HERE,  
-				[this, packet_ = std::move(bufer) ]() {
-				RTC_DCHECK_RUN_ON(context_->signaling_thread());
-				rtp_rtcp_impl_->IncomingRtcpPacket(packet_.cdata(), packet_.size());
-			});
+			if (!header.Parse(next, end - next))
+			{
+				break;
+			}
+			const size_t index = static_cast<size_t>(header.type()) - kRtcpFirstPacketType;
+			if (header.type() < kRtcpFirstPacketType || index >= kRtcpPacketTypes ||
+				!(this->*kRtcpHandlers[index])(header))
+			{
+				if (!copying)
+				{
+					copying = true;
+					report_packets.EnsureCapacity(packet->size());
+					report_packets.AppendData(begin, reports_end - begin);
+				}
+				continue;
+			}
+			if (copying)
+			{
+				report_packets.AppendData(next, header.NextPacket() - next);
+			}
+			else
+			{
+				reports_end = header.NextPacket();
+			}
+		}
+		if (!copying)
+		{
+			report_packets = packet->Slice(0, reports_end - begin);
+		}
+		if (!rtp_rtcp_impl_ || report_packets.size() == 0)
+		{
+			return;
+		}
+		context_->signaling_thread()->PostTask(/*webrtc::ToQueuedTask(signaling_thread_safety_.flag(),*/RTC_FROM_HERE,
+			[this, packet_ = std::move(report_packets)]() {
+			RTC_DCHECK_RUN_ON(context_->signaling_thread());
+			rtp_rtcp_impl_->IncomingRtcpPacket(packet_.cdata(), packet_.size());
+		});
+	}
+	bool p2p_peer_connection::OnRtcpReport_n(const libmedia_transfer_protocol::rtcp::CommonHeader & header)
+	{
+		return true;
+	}
+	bool p2p_peer_connection::OnRtcpApp_n(const libmedia_transfer_protocol::rtcp::CommonHeader & header)
+	{
+		return false;
+	}
+	bool p2p_peer_connection::OnRtpFeedback_n(const libmedia_transfer_protocol::rtcp::CommonHeader & header)
+	{
+		switch (header.fmt())
+		{
+		case libmedia_transfer_protocol::rtcp::Nack::kFeedbackMessageType:
+		{
+			// NACK在网络线程直接处理, 减少重传延迟
+			libmedia_transfer_protocol::rtcp::Nack nack;
+			if (video_history_ && nack.Parse(header) && nack.media_ssrc() == local_video_ssrc_)
+			{
+				OnReceivedNack_n(nack.packet_ids());
+			}
+			return false;
+		}
+		case libmedia_transfer_protocol::rtcp::TransportFeedback::kFeedbackMessageType:
+		{
+			// transport-cc反馈直接交给拥塞控制
+			libmedia_transfer_protocol::rtcp::TransportFeedback feedback;
+			if (transport_send_ && feedback.Parse(header))
+			{
+				transport_send_->OnTransportFeedback(feedback);
+			}
+			return false;
+		}
+		default:
+			return true;
+		}
+	}
+	bool p2p_peer_connection::OnPayloadFeedback_n(const libmedia_transfer_protocol::rtcp::CommonHeader & header)
+	{
+		switch (header.fmt())
+		{
+		case libmedia_transfer_protocol::rtcp::Pli::kFeedbackMessageType:
+		{
+			libmedia_transfer_protocol::rtcp::Pli pli;
+			if (pli.Parse(header) && pli.media_ssrc() == local_video_ssrc_)
+			{
+				OnKeyFrameRequested_n();
+			}
+			return false;
+		}
+		case libmedia_transfer_protocol::rtcp::Fir::kFeedbackMessageType:
+		{
+			libmedia_transfer_protocol::rtcp::Fir fir;
+			if (!fir.Parse(header))
+			{
+				return false;
+			}
+			for (const libmedia_transfer_protocol::rtcp::Fir::Request & request : fir.requests())
+			{
+				if (request.ssrc == local_video_ssrc_)
+				{
+					OnKeyFrameRequested_n();
+					break;
+				}
+			}
+			return false;
+		}
+		case libmedia_transfer_protocol::rtcp::Remb::kFeedbackMessageType:
+		{
+			// REMB直接交给拥塞控制; 同一fmt的其他AFB交给rtp_rtcp_impl_
+			libmedia_transfer_protocol::rtcp::Remb remb;
+			if (!remb.Parse(header))
+			{
+				return true;
+			}
+			if (transport_send_)
+			{
+				transport_send_->OnReceivedEstimatedBitrate(static_cast<uint32_t>(remb.bitrate_bps()));
+			}
+			return false;
+		}
+		default:
+			return true;
 		}
 	}
+	void p2p_peer_connection::OnKeyFrameRequested_n()
+	{
+		// 编码器在应用侧, 只有这个事件需要跨线程
+		context_->signaling_thread()->PostTask(RTC_FROM_HERE, [this]() {
+			RTC_DCHECK_RUN_ON(context_->signaling_thread());
+			SignalKeyFrameRequested(this);
+		});
+	}
+	void p2p_peer_connection::OnRtpTransportChanged_n(const std::string & mid, RtpTransportInternal * rtp_transport,
+		uint32_t transport_generation)
+	{
+		RTC_DCHECK_RUN_ON(context_->network_thread());
+		// BUNDLE时audio/video绑定到同一个transport, 不BUNDLE时各自独立
+		if (mid == "audio")
+		{
+			audio_rtp_transport_.store(rtp_transport, std::memory_order_release);
+			audio_rtp_transport_generation_.store(transport_generation, std::memory_order_release);
+		}
+		else if (mid == "video")
+		{
+			RtpTransportInternal * old_transport = video_rtp_transport_.exchange(rtp_transport, std::memory_order_acq_rel);
+			video_rtp_transport_generation_.store(transport_generation, std::memory_order_release);
+			if (old_transport != rtp_transport)
+			{
+				if (old_transport)
+				{
+					old_transport->SignalNetworkRouteChanged.disconnect(this);
+					if (video_receiver_)
+					{
+						old_transport->UnregisterRtpDemuxerSink(video_receiver_.get());
+					}
+				}
+				if (rtp_transport)
+				{
+					rtp_transport->SignalNetworkRouteChanged.connect(this, &p2p_peer_connection::OnVideoNetworkRouteChanged_n);
+					if (video_receiver_)
+					{
+						// 对端的视频SSRC不在SDP里解析, 按payload type分发, demuxer会记住SSRC
+						webrtc::RtpDemuxerCriteria criteria;
+						criteria.payload_types.insert(video_receiver_->payload_type());
+						if (video_receiver_->rtx_payload_type() != 0)
+						{
+							criteria.payload_types.insert(video_receiver_->rtx_payload_type());
+						}
+						rtp_transport->RegisterRtpDemuxerSink(criteria, video_receiver_.get());
+					}
+				}
+				video_transport_overhead_.store(kDefaultTransportOverhead, std::memory_order_relaxed);
+			}
+		}
+	}
+	void p2p_peer_connection::SetRemoteVideoSink(EncodedVideoFrameSinkInterface * sink)
+	{
+		remote_video_sink_ = sink;
+		if (video_receiver_)
+		{
+			video_receiver_->SetSink(sink);
+		}
+	}
+	bool p2p_peer_connection::SetBaseMinimumPlayoutDelayMs(int delay_ms)
+	{
+		if (delay_ms < 0 || delay_ms > VideoJitterBuffer::kMaxBaseMinimumDelayMs)
+		{
+			RTC_LOG(LS_WARNING) << "invalid base minimum playout delay: " << delay_ms;
+			return false;
+		}
+		base_minimum_playout_delay_ms_ = delay_ms;
+		if (video_receiver_)
+		{
+			video_receiver_->SetBaseMinimumPlayoutDelayMs(delay_ms);
+		}
+		return true;
+	}
+	int p2p_peer_connection::GetBaseMinimumPlayoutDelayMs() const
+	{
+		return base_minimum_playout_delay_ms_;
+	}
+	void p2p_peer_connection::SetLowLatencyMode(bool enabled)
+	{
+		low_latency_mode_ = enabled;
+		if (video_receiver_)
+		{
+			video_receiver_->SetLowLatencyMode(enabled);
+		}
+	}
+	void p2p_peer_connection::SendPli_n(uint32_t media_ssrc)
+	{
+		libmedia_transfer_protocol::rtcp::Pli pli;
+		pli.SetSenderSsrc(local_video_ssrc_ != 0 ? local_video_ssrc_ : local_audio_ssrc_);
+		pli.SetMediaSsrc(media_ssrc);
+		const rtc::Buffer packet = pli.Build();
+		transport_controller_->send_rtcp_packet("video", rtc::CopyOnWriteBuffer(packet.data(), packet.size()));
+	}
+	void p2p_peer_connection::SendNack_n(uint32_t media_ssrc, const std::vector<uint16_t>& sequence_numbers)
+	{
+		libmedia_transfer_protocol::rtcp::Nack nack;
+		nack.SetSenderSsrc(local_video_ssrc_ != 0 ? local_video_ssrc_ : local_audio_ssrc_);
+		nack.SetMediaSsrc(media_ssrc);
+		nack.SetPacketIds(sequence_numbers.data(), sequence_numbers.size());
+		const rtc::Buffer packet = nack.Build();
+		transport_controller_->send_rtcp_packet("video", rtc::CopyOnWriteBuffer(packet.data(), packet.size()));
+	}
+	void p2p_peer_connection::OnVideoNetworkRouteChanged_n(absl::optional<rtc::NetworkRoute> network_route)
+	{
+		RTC_DCHECK_RUN_ON(context_->network_thread());
+		int overhead = kDefaultTransportOverhead;
+		if (network_route)
+		{
+			// packet_overhead包括IP/UDP(TCP)和TURN, SRTP激活后SrtpTransport会加上SRTP开销
+			overhead = network_route->packet_overhead;
+			RtpTransportInternal * rtp_transport = video_rtp_transport_.load(std::memory_order_acquire);
+			if (!rtp_transport || !rtp_transport->IsSrtpActive())
+			{
+				overhead += static_cast<int>(kSrtpMaxRtpTrailerLen);
+			}
+		}
+		RTC_LOG(LS_INFO) << "video transport overhead: " << overhead;
+		video_transport_overhead_.store(overhead, std::memory_order_relaxed);
+	}
+	size_t p2p_peer_connection::VideoMaxPayloadSize(size_t rtp_header_size) const
+	{
+		const size_t transport_overhead = video_transport_overhead_.load(std::memory_order_relaxed);
+		const size_t max_packet_size = std::min(kDefaultMaxPacketSize, kPathMtu - transport_overhead);
+		size_t overhead = rtp_header_size;
+		// FEC包比它保护的最大媒体包还要大
+		if (flexfec_sender_)
+		{
+			overhead += FlexfecSender::PacketOverhead(rtp_header_size);
+		}
+		return max_packet_size - overhead;
+	}
 	void p2p_peer_connection::OnNetworkInfo(const libmedia_transfer_protocol:: ReportBlockList&  reportblocks, int64_t rtt_ms, int64_t now_ms)
 	{
+		if (video_history_)
+		{
+			video_history_->SetRtt(rtt_ms);
+		}
+		if (video_receiver_)
+		{
+			// 接收端的NACK重传间隔按RTT调整
+			context_->network_thread()->PostTask(RTC_FROM_HERE, [this, rtt_ms]() {
+				RTC_DCHECK_RUN_ON(context_->network_thread());
+				if (video_receiver_)
+				{
+					video_receiver_->UpdateRtt(rtt_ms);
+				}
+			});
+		}
 		if (transport_send_)
 		{
 			transport_send_->OnRttUpdate(rtt_ms, webrtc::Timestamp::Millis(now_ms));
@@ -593,7 +1135,8 @@ namespace libp2p_peerconnection
 			
 		}
 	}
-	void   p2p_peer_connection::SendVideoEncode(std::shared_ptr<libmedia_codec::EncodedImage> encoded_image)
+	void   p2p_peer_connection::SendVideoEncode(std::shared_ptr<libmedia_codec::EncodedImage> encoded_image,
+		size_t num_spatial_layers, bool end_of_picture)
 	{
 	//	RTC_LOG_F(LS_INFO) << "";
 
@@ -607,21 +1150,52 @@ namespace libp2p_peerconnection
 				frame->fmt.sub_fmt.video_fmt.idr);
 		}
 */
+		// 一帧的包头都一样, 只在模板包中写一次头和扩展
+		// 预留SRTP trailer空间, 网络线程可以原地加密, 不需要重新分配
+		libmedia_transfer_protocol::RtpPacketToSend  template_packet(&rtp_header_extension_map_,
+			kRtpPacketBufferCapacity);
+		template_packet.SetPayloadType(video_pt_);
+		template_packet.SetTimestamp(rtp_timestamp);
+		template_packet.SetSsrc(local_video_ssrc_);
+		template_packet.ReserveExtension<libmedia_transfer_protocol::TransportSequenceNumber>();
+		template_packet.set_packet_type(libmedia_transfer_protocol::RtpPacketMediaType::kVideo);
+
 		//RTPVideoHeader::RtpPacketizer::Config config;
 #if 1
 		libmedia_transfer_protocol::RtpPacketizer::PayloadSizeLimits   lists;
+		// 包头(含扩展)按模板包的实际大小计算
+		lists.max_payload_len = static_cast<int>(VideoMaxPayloadSize(template_packet.headers_size()));
 		libmedia_transfer_protocol::RTPVideoHeader   rtp_video_hreader;
 		//rtc::Buffer encrypted_video_payload;
 		//encrypted_video_payload.SetSize(encoded_image->size());
 	//	encrypted_video_payload.SetData(encoded_image->size(), encoded_image->data());
-	//	rtp_video_hreader.video_type_header = absl::variant<webrtc::RTPVideoHeaderH264>;
-		webrtc::RTPVideoHeaderH264  h;
-		// 多包和分包
-		h.packetization_mode = webrtc::H264PacketizationMode::NonInterleaved;
-		rtp_video_hreader.video_type_header = h;
+		const VideoCodecEntry * video_codec = FindVideoCodec(video_codec_type_);
+		if (!video_codec)
+		{
+			return;
+		}
+		// 只有VP9打包支持空间层; 层号必须在层数之内, 多层时每层都要带层号
+		const bool spatial_layers_valid = encoded_image->SpatialIndex()
+			? *encoded_image->SpatialIndex() >= 0 &&
+				static_cast<size_t>(*encoded_image->SpatialIndex()) < num_spatial_layers
+			: num_spatial_layers == 1;
+		if (num_spatial_layers == 0 || num_spatial_layers > webrtc::kMaxVp9NumberOfSpatialLayers || !spatial_layers_valid ||
+			(num_spatial_layers > 1 && video_codec->type != libmedia_codec::kVideoCodecVP9))
+		{
+			RTC_LOG(LS_WARNING) << "invalid spatial layer, index: " << encoded_image->SpatialIndex().value_or(-1)
+				<< ", layers: " << num_spatial_layers << ", codec: " << video_codec->name;
+			return;
+		}
+		rtp_video_hreader.frame_type = encoded_image->_frameType;
+		rtp_video_hreader.width = encoded_image->_encodedWidth;
+		rtp_video_hreader.height = encoded_image->_encodedHeight;
+		if (video_codec->fill_video_header)
+		{
+			video_codec->fill_video_header(*encoded_image, num_spatial_layers, end_of_picture, &rtp_video_hreader);
+		}
 		std::unique_ptr<libmedia_transfer_protocol::RtpPacketizer> packetizer = 
 			libmedia_transfer_protocol::RtpPacketizer::Create(
-				libmedia_codec::kVideoCodecH264, rtc::ArrayView<const uint8_t>(encoded_image->data(), encoded_image->size()),
+				video_codec->type, rtc::ArrayView<const uint8_t>(encoded_image->data(), encoded_image->size()),
 			lists, rtp_video_hreader);
 #else 
 
@@ -632,26 +1206,24 @@ namespace libp2p_peerconnection
 
 #endif 
 
+		const size_t num_packets = packetizer->NumPackets();
 		std::vector< std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>>  packets;
-		while (true) 
+		packets.reserve(num_packets);
+		// 一帧的buffer一次从pool取出, 已经写好模板包头; 网络线程发送后还回pool
+		video_packet_buffers_.clear();
+		transport_controller_->AcquireRtpSendBuffers(template_packet.data(), template_packet.size(),
+			kRtpPacketBufferCapacity, num_packets, &video_packet_buffers_);
+		for (size_t i = 0; i < num_packets; ++i)
 		{
-			auto  single_packet = std::make_shared<libmedia_transfer_protocol::RtpPacketToSend>(&rtp_header_extension_map_);
-
-		 
-
-			single_packet->SetPayloadType(video_pt_);
-			single_packet->SetTimestamp(rtp_timestamp);
-			single_packet->SetSsrc(local_video_ssrc_);
-			single_packet->ReserveExtension<libmedia_transfer_protocol::TransportSequenceNumber>();
-			
+			// 包对象仍然每个包分配一次(pacer按unique_ptr接管并释放), buffer换成pool里的,
+			// packetizer写payload时buffer只有一个引用, 不会copy-on-write分配
+			auto  single_packet = std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(template_packet);
+			single_packet->Parse(std::move(video_packet_buffers_[i]));
 			if (!packetizer->NextPacket(single_packet.get())) {
 				break;
 			}
-			int16_t   packet_id = transprot_seq_++;
+			// transport-cc序号在pacer发送时分配, 重传包也需要
 			single_packet->SetSequenceNumber(video_seq_++);
-			single_packet->set_packet_type(libmedia_transfer_protocol::RtpPacketMediaType::kVideo);
-			single_packet->SetExtension<libmedia_transfer_protocol::TransportSequenceNumber>(packet_id);
-			AddPacketToTransportFeedback(packet_id, single_packet.get());
 			//if (video_send_stream_) {
 			//	video_send_stream_->UpdateRtpStats(single_packet, false, false);
 			//}
@@ -662,21 +1234,35 @@ namespace libp2p_peerconnection
 		//	SendPacket("audio",  single_packet.get() );
 			//std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> packet =
 			//	std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(*single_packet);
-			packets.emplace_back(std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(*single_packet));
+			packets.push_back(std::move(single_packet));
 		}
 		transport_send_->EnqueuePacket(std::move(packets));
 	}
 	void p2p_peer_connection::SendAudioEncode(
 		std::shared_ptr<libmedia_codec::AudioEncoder::EncodedInfoLeaf> frame)
 	{
-		return;
-		auto  packet = std::make_shared<libmedia_transfer_protocol::RtpPacketToSend>(&rtp_header_extension_map_);
+		if (!transport_send_ || local_audio_ssrc_ == 0 || frame->encoded_bytes == 0)
+		{
+			return;
+		}
+		// 容量不小于pool的小buffer, 发送后buffer在网络线程回收, 收包时复用
+		const size_t capacity = std::max(PacketBufferPool::kSmallBufferCapacity,
+			kAudioRtpHeaderReserve + frame->encoded_bytes + PacketBufferPool::kTrailerHeadroom);
+		auto  packet = std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(&rtp_header_extension_map_,
+			capacity);
 		//packet->SetMarker(MarkerBit(frame_type, payload_type));
 		packet->SetPayloadType(audio_pt_);
 		packet->SetTimestamp(frame->encoded_timestamp);
 		packet->SetSsrc(local_audio_ssrc_);
-		packet->SetSequenceNumber(audio_seq_++);
+		const uint16_t sequence_number = audio_seq_++;
+		packet->SetSequenceNumber(sequence_number);
 		packet->set_packet_type(libmedia_transfer_protocol::RtpPacketMediaType::kAudio);
+		// transport-cc序号在pacer发送时分配
+		packet->ReserveExtension<libmedia_transfer_protocol::TransportSequenceNumber>();
+		// 编码完成的时间, 网络线程写完socket后统计编码到发出的延迟
+		audio_encode_time_us_[sequence_number % kAudioEncodeTimeSlots].store(
+			(uint64_t{ sequence_number } << kEncodeTimeBits) | (static_cast<uint64_t>(rtc::TimeMicros()) & kEncodeTimeMask),
+			std::memory_order_release);
 
 		uint8_t* payload = packet->AllocatePayload(frame->encoded_bytes);
 		if (!payload)  // Too large payload buffer.
@@ -684,8 +1270,10 @@ namespace libp2p_peerconnection
 			return;
 		}
 		memcpy(payload, frame->audio_encode_data.data(), frame->encoded_bytes);
-		SendPacket("audio", packet.get());
-		//packet->set_capture_time_ms(clock_->TimeInMilliseconds());
+		// 走pacer, 音频优先级最高, 不会排在视频突发的后面
+		std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>> packets;
+		packets.push_back(std::move(packet));
+		transport_send_->EnqueuePacket(std::move(packets));
 	}
 	void p2p_peer_connection::AddPacketToTransportFeedback(uint16_t transport_seq, 
 		 libmedia_transfer_protocol::RtpPacketToSend* packet)
@@ -731,34 +1319,135 @@ namespace libp2p_peerconnection
 	  void p2p_peer_connection::SendPacket(std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> packet,
 		const libice::PacedPacketInfo& cluster_info)
 	{
-		  transport_controller_->send_rtp_packet("audio", (const char *)packet->data(),
-			  packet->size());
+		  const int64_t now_ms = rtc::TimeMillis();
+		  // RTX流(重传和padding)的序号按实际发送顺序分配
+		  if (packet->Ssrc() == local_video_rtx_ssrc_ && local_video_rtx_ssrc_ != 0)
+		  {
+			  packet->SetSequenceNumber(rtx_seq_++);
+		  }
+		  // 所有包(包括重传)都分配transport-cc序号
+		  uint16_t packet_id = transprot_seq_++;
+		  packet->SetExtension<libmedia_transfer_protocol::TransportSequenceNumber>(packet_id);
+		  AddPacketToTransportFeedback(packet_id, packet.get());
+
 		  //发送统计数据
 		  rtc::SentPacket sent;
-		  sent.send_time_ms = rtc::TimeMillis();
-		  if (auto packet_id = packet->GetExtension<libmedia_transfer_protocol::TransportSequenceNumber>())
+		  sent.send_time_ms = now_ms;
+		  sent.packet_id = packet_id;
+
+		  int64_t encode_time_us = 0;
+		  if (packet->packet_type() == libmedia_transfer_protocol::RtpPacketMediaType::kAudio)
+		  {
+			  const uint64_t slot = audio_encode_time_us_[packet->SequenceNumber() % kAudioEncodeTimeSlots].load(
+				  std::memory_order_acquire);
+			  // slot已被后面的包覆盖时不统计
+			  if (static_cast<uint16_t>(slot >> kEncodeTimeBits) == packet->SequenceNumber())
+			  {
+				  encode_time_us = static_cast<int64_t>(slot & kEncodeTimeMask);
+			  }
+		  }
+		  if (video_history_)
+		  {
+			  if (packet->packet_type() == libmedia_transfer_protocol::RtpPacketMediaType::kVideo)
+			  {
+				  // history和FEC在pacer线程上拷贝一份自己的buffer, 发给网络线程的buffer只有一个引用,
+				  // SRTP原地加密; 共享buffer的话网络线程加密时会copy-on-write拷贝
+				  auto history_packet = std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(*packet);
+				  history_packet->Parse(rtc::CopyOnWriteBuffer(packet->data(), packet->size()));
+				  transport_controller_->CountRtpPacketCopy();
+				  if (flexfec_sender_)
+				  {
+					  // FEC组只读, 和history共用拷贝出来的buffer
+					  flexfec_sender_->AddPacketToProtect(*history_packet);
+				  }
+				  video_history_->PutRtpPacket(std::move(history_packet), now_ms);
+			  }
+			  else if (packet->packet_type() == libmedia_transfer_protocol::RtpPacketMediaType::kRetransmission)
+			  {
+				  video_history_->OnRetransmissionSent(packet->size(), now_ms);
+			  }
+		  }
+		  // 直接把packet的buffer交给网络线程, 释放packet后buffer只有一个引用(history/FEC用的是拷贝),
+		  // SRTP加密时不会触发copy-on-write拷贝
+		  // 先读本流的generation再读transport, 网络线程据此只丢弃这个流的transport已被替换的包
+		  const bool audio = packet->packet_type() == libmedia_transfer_protocol::RtpPacketMediaType::kAudio;
+		  const uint32_t transport_generation = audio
+			  ? audio_rtp_transport_generation_.load(std::memory_order_acquire)
+			  : video_rtp_transport_generation_.load(std::memory_order_acquire);
+		  RtpTransportInternal * rtp_transport = audio
+			  ? audio_rtp_transport_.load(std::memory_order_acquire)
+			  : video_rtp_transport_.load(std::memory_order_acquire);
+		  rtc::CopyOnWriteBuffer buffer = packet->Buffer();
+		  packet.reset();
+		  if (!rtp_transport)
+		  {
+			  // 还没有协商完成
+			  RTC_LOG(LS_VERBOSE) << "no rtp transport bound, drop packet";
+		  }
+		  else
 		  {
-			  sent.packet_id = *packet_id;
+			  // pacer一轮(ProcessPackets)发送的包攒在一起, 这一轮结束后一次交给网络线程
+			  webrtc::TaskQueueBase * pacer_queue = webrtc::TaskQueueBase::Current();
+			  if (send_burst_.empty() && pacer_queue)
+			  {
+				  pacer_queue->PostTask(webrtc::ToQueuedTask([this]() { FlushSendBurst(); }));
+			  }
+			  send_burst_.push_back({ rtp_transport, transport_generation, std::move(buffer), encode_time_us });
+			  if (!pacer_queue)
+			  {
+				  FlushSendBurst();
+			  }
 		  }
 
 		  transport_send_->OnSentPacket(sent);
 	}
+	  void p2p_peer_connection::FlushSendBurst()
+	  {
+		  transport_controller_->send_rtp_packets(&send_burst_);
+	  }
 	// Should be called after each call to SendPacket().
 	  std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>> p2p_peer_connection::FetchFec()
 	{
+		  // 一帧(或15个连续包)发完后才会生成FEC包
+		  if (flexfec_sender_)
+		  {
+			  return flexfec_sender_->GetFecPackets();
+		  }
 		  std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>> result;
 		  return result;
 	}
 	  std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>> p2p_peer_connection::GeneratePadding(
 		webrtc::DataSize size)
 	{
-		  // 设置探测包padding 结构
 		  std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>> result;
+		  if (local_video_rtx_ssrc_ == 0)
+		  {
+			  return result;
+		  }
+		  // 优先用history中最近发送的包通过RTX重发, 探测带宽的同时提供冗余;
+		  // 在history锁内直接从保存的包生成RTX包, 不再先拷贝一份
+		  if (video_history_)
+		  {
+			  result.reserve(RtpPacketHistory::kMaxPaddingPackets);
+			  video_history_->VisitPacketsForPadding(size.bytes(), rtc::TimeMillis(),
+				  [this, &result](const libmedia_transfer_protocol::RtpPacketToSend & packet) {
+				  std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> rtx_packet = BuildRtxPacket(packet);
+				  if (rtx_packet)
+				  {
+					  // 不计入重传统计
+					  rtx_packet->set_packet_type(libmedia_transfer_protocol::RtpPacketMediaType::kPadding);
+					  result.push_back(std::move(rtx_packet));
+				  }
+			  });
+			  if (!result.empty())
+			  {
+				  return result;
+			  }
+		  }
 
-		  auto  padding_packet = std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(&rtp_header_extension_map_);
-
-
-
+		  // history为空(还没有发送视频)时才发送纯padding包
+		  auto  padding_packet = std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(&rtp_header_extension_map_,
+			  kPaddingPacketCapacity);
 		  padding_packet->SetPayloadType(video_rtx_pt_);
 		  padding_packet->SetTimestamp(rtc::SystemTimeMillis());
 		  padding_packet->SetSsrc(local_video_rtx_ssrc_);
@@ -766,16 +1455,84 @@ namespace libp2p_peerconnection
 		 // padding_packet->set_packet_type(packet-)
 		  padding_packet->ReserveExtension<libmedia_transfer_protocol::TransportSequenceNumber>();
 
-		  
-		   int16_t   packet_id = transprot_seq_++;
-		  padding_packet->SetSequenceNumber(video_seq_++);
+		  // RTX序号和transport-cc序号在SendPacket中分配
 		  padding_packet->set_packet_type(libmedia_transfer_protocol::RtpPacketMediaType::kPadding);
-		  padding_packet->SetExtension<libmedia_transfer_protocol::TransportSequenceNumber>(packet_id);
-		  AddPacketToTransportFeedback(packet_id, padding_packet.get());
-		  padding_packet->SetPadding(size.bytes());
+		  padding_packet->SetPadding(std::min<size_t>(size.bytes(), kMaxPaddingLength));
 		  result.push_back(std::move(padding_packet));
 		  return result;
 	}
+	void p2p_peer_connection::OnReceivedNack_n(const std::vector<uint16_t>& sequence_numbers)
+	{
+		if (!transport_send_ || local_video_rtx_ssrc_ == 0)
+		{
+			return;
+		}
+		const int64_t now_ms = rtc::TimeMillis();
+		std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>> packets;
+		packets.reserve(sequence_numbers.size());
+		for (uint16_t sequence_number : sequence_numbers)
+		{
+			std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> packet =
+				video_history_->GetPacketAndMarkAsRetransmitted(sequence_number, now_ms);
+			if (!packet)
+			{
+				continue;
+			}
+			std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> rtx_packet = BuildRtxPacket(*packet);
+			if (rtx_packet)
+			{
+				packets.push_back(std::move(rtx_packet));
+			}
+		}
+		if (!packets.empty())
+		{
+			// 重传包也走pacer, 受拥塞控制码率限制
+			transport_send_->EnqueuePacket(std::move(packets));
+		}
+	}
+	std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> p2p_peer_connection::BuildRtxPacket(
+		const libmedia_transfer_protocol::RtpPacketToSend& packet)
+	{
+		// 同视频打包: 包头(时间戳/marker/扩展)沿用原包, buffer从transport_controller的pool取,
+		// 已经写好原包的头, 网络线程发送后还回pool
+		auto rtx_packet = std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(packet);
+		if (!rtx_packet->Parse(transport_controller_->AcquireRtpSendBuffer(packet.data(), packet.headers_size(),
+			kRtpPacketBufferCapacity)))
+		{
+			RTC_LOG(LS_WARNING) << "failed to parse rtx header, seq: " << packet.SequenceNumber();
+			return nullptr;
+		}
+		rtx_packet->SetPayloadType(video_rtx_pt_);
+		rtx_packet->SetSsrc(local_video_rtx_ssrc_);
+		rtx_packet->set_packet_type(libmedia_transfer_protocol::RtpPacketMediaType::kRetransmission);
+
+		// payload = OSN(2字节) + 原始payload
+		rtc::ArrayView<const uint8_t> payload = packet.payload();
+		uint8_t* rtx_payload = rtx_packet->AllocatePayload(kRtxHeaderSize + payload.size());
+		if (!rtx_payload)
+		{
+			RTC_LOG(LS_WARNING) << "rtx packet too large, seq: " << packet.SequenceNumber();
+			return nullptr;
+		}
+		webrtc::ByteWriter<uint16_t>::WriteBigEndian(rtx_payload, packet.SequenceNumber());
+		memcpy(rtx_payload + kRtxHeaderSize, payload.data(), payload.size());
+		return rtx_packet;
+	}
+	RtpPacketHistory::Stats p2p_peer_connection::GetVideoRetransmissionStats()
+	{
+		if (!video_history_)
+		{
+			return RtpPacketHistory::Stats();
+		}
+		return video_history_->GetStats(rtc::TimeMillis());
+	}
+	PacketLatencyHistogram p2p_peer_connection::GetAudioSendLatency()
+	{
+		return context_->network_thread()->Invoke<PacketLatencyHistogram>(RTC_FROM_HERE, [this]() {
+			RTC_DCHECK_RUN_ON(context_->network_thread());
+			return transport_controller_->GetEncodeToWireLatency_n();
+		});
+	}
 	void p2p_peer_connection::CreateVideoChannel()
 	{
 		libmedia_transfer_protocol::MediaConfig  media_config;
@@ -801,7 +1558,17 @@ namespace libp2p_peerconnection
 		int64_t rtt,
 		int64_t now_ms)
 	{
-		//for (const libmedia_transfer_protocol::RTCPReportBlock & reportblock : report_blocks)
+		// 按对端反馈的丢包率调整FEC保护比例
+		if (flexfec_sender_)
+		{
+			for (const libmedia_transfer_protocol::RTCPReportBlock & reportblock : report_blocks)
+			{
+				if (reportblock.source_ssrc == local_video_ssrc_)
+				{
+					flexfec_sender_->OnReceivedFractionLost(reportblock.fraction_lost);
+				}
+			}
+		}
 		{
 			OnNetworkInfo(report_blocks, rtt, now_ms);
 		}
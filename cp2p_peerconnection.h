@@ -21,13 +21,21 @@
 
 #ifndef _C_P2P_PEER_CONNECTION_H_
 #define _C_P2P_PEER_CONNECTION_H_
+#include <array>
+#include <atomic>
 #include "rtc_base/third_party/sigslot/sigslot.h"
 #include "libp2p_peerconnection/csession_description.h"
 #include "libp2p_peerconnection/ctransport_controller.h"
+#include "libp2p_peerconnection/flexfec_sender.h"
+#include "libp2p_peerconnection/rtp_config.h"
+#include "libp2p_peerconnection/rtp_packet_history.h"
+#include "libp2p_peerconnection/rtp_video_stream_receiver.h"
+#include "libp2p_peerconnection/transport_perf_stats.h"
 //#include "libp2p_peerconnection/engine/webrtc_media_engine.h"
 #include "libmedia_codec/encoded_image.h"
 #include "libmedia_codec/x264_encoder.h"
 #include "libmedia_transfer_protocol/rtp_rtcp/rtp_header_extension_map.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtcp_packet/common_header.h"
 #include "libmedia_transfer_protocol/rtp_transport_controller_send.h"
 #include "libmedia_transfer_protocol/pacing/pacing_controller.h"
 #include "libmedia_codec/audio_codec/opus_encoder.h"
@@ -70,10 +78,16 @@ namespace libp2p_peerconnection
 		void OnRtcpPacketReceived_n(
 			rtc::CopyOnWriteBuffer* packet,
 			int64_t packet_time_us);
+		// 协商完成后mid绑定的RtpTransport, 发送时直接使用
+		void OnRtpTransportChanged_n(const std::string& mid, RtpTransportInternal* rtp_transport, uint32_t transport_generation);
+		// 选中的candidate pair变化, 更新IP/UDP/TURN/SRTP开销
+		void OnVideoNetworkRouteChanged_n(absl::optional<rtc::NetworkRoute> network_route);
 
 
 
 		sigslot::signal2<p2p_peer_connection*, const libice::TargetTransferRate&> SignalTargetTransferRate;
+		// 对端PLI/FIR请求本地视频关键帧, 在信令线程回调
+		sigslot::signal1<p2p_peer_connection*> SignalKeyFrameRequested;
 
 
 		void OnTragetTransferRate(libmedia_transfer_protocol::RtpTransportControllerSend* , const libice::TargetTransferRate& target);
@@ -89,7 +103,12 @@ namespace libp2p_peerconnection
 	
 	
 	public:
-		  void   SendVideoEncode(std::shared_ptr<libmedia_codec::EncodedImage> encoded_image)  ;
+		// 协商后的视频codec, 调用方按此选择编码器; SendVideoEncode按此打包
+		libmedia_codec::VideoCodecType GetNegotiatedVideoCodecType() const { return video_codec_type_; }
+		// VP9 SVC每个空间层调用一次, EncodedImage不带层数和是否最高层, 由调用方给出:
+		// num_spatial_layers为总层数, end_of_picture只在最高层为true
+		  void   SendVideoEncode(std::shared_ptr<libmedia_codec::EncodedImage> encoded_image,
+			  size_t num_spatial_layers = 1, bool end_of_picture = true)  ;
 		void   SendAudioEncode(std::shared_ptr<libmedia_codec::AudioEncoder::EncodedInfoLeaf> f)  ;
 
 
@@ -97,6 +116,19 @@ namespace libp2p_peerconnection
 		void AddPacketToTransportFeedback(uint16_t   transport_seq,
 			 libmedia_transfer_protocol::RtpPacketToSend* packet);
 
+		// 视频重传统计(history命中/未命中, 重传码率)
+		RtpPacketHistory::Stats GetVideoRetransmissionStats();
+		// 音频从编码完成到写入socket的延迟分布(us), 不能在网络线程上调用
+		PacketLatencyHistogram GetAudioSendLatency();
+
+		// 接收对端视频(H264), 组好的完整帧在worker线程回调; 与set_remote_sdp在同一线程调用
+		void SetRemoteVideoSink(EncodedVideoFrameSinkInterface* sink);
+		// 接收端jitter buffer的最小播放延迟(ms), 超出[0, 10000]返回false
+		bool SetBaseMinimumPlayoutDelayMs(int delay_ms);
+		int GetBaseMinimumPlayoutDelayMs() const;
+		// 低延迟模式(云游戏): 帧完整后立即回调, 不做jitter平滑
+		void SetLowLatencyMode(bool enabled);
+
 
 	public:
 
@@ -109,6 +141,28 @@ namespace libp2p_peerconnection
 			webrtc::DataSize size) override;
 	private:
 		void SendPacket(const std::string & transport_name, libmedia_transfer_protocol::RtpPacketToSend * packet);
+		// pacer线程: 把这一轮攒下的包一次交给transport_controller
+		void FlushSendBurst();
+		// 按MTU和实际开销计算视频包最大payload, 避免中继路径上IP分片
+		size_t VideoMaxPayloadSize(size_t rtp_header_size) const;
+		// 收到NACK, 从history取出包封装成RTX交给pacer
+		void OnReceivedNack_n(const std::vector<uint16_t>& sequence_numbers);
+		// RTCP按类型分发的处理函数, 返回true表示该块需要交给rtp_rtcp_impl_
+		using RtcpHandler = bool (p2p_peer_connection::*)(const libmedia_transfer_protocol::rtcp::CommonHeader& header);
+		static constexpr uint8_t kRtcpFirstPacketType = 200;
+		static constexpr size_t kRtcpPacketTypes = 8;
+		static const RtcpHandler kRtcpHandlers[kRtcpPacketTypes];
+		bool OnRtcpReport_n(const libmedia_transfer_protocol::rtcp::CommonHeader& header);
+		bool OnRtcpApp_n(const libmedia_transfer_protocol::rtcp::CommonHeader& header);
+		bool OnRtpFeedback_n(const libmedia_transfer_protocol::rtcp::CommonHeader& header);
+		bool OnPayloadFeedback_n(const libmedia_transfer_protocol::rtcp::CommonHeader& header);
+		void OnKeyFrameRequested_n();
+		std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> BuildRtxPacket(
+			const libmedia_transfer_protocol::RtpPacketToSend& packet);
+		// 请求对端发送关键帧
+		void SendPli_n(uint32_t media_ssrc);
+		// 请求对端重传丢失的视频包
+		void SendNack_n(uint32_t media_ssrc, const std::vector<uint16_t>& sequence_numbers);
 	private:
 		rtc::scoped_refptr<libp2p_peerconnection::ConnectionContext> context_;
 		std::unique_ptr<libp2p_peerconnection::SessionDescription> remote_desc_;
@@ -121,8 +175,12 @@ namespace libp2p_peerconnection
 		uint32_t local_audio_ssrc_ = 0;
 		uint32_t local_video_ssrc_ = 0;
 		uint32_t local_video_rtx_ssrc_ = 0;
+		uint32_t local_video_flexfec_ssrc_ = 0;
 		uint8_t video_pt_ = 0;
+		libmedia_codec::VideoCodecType video_codec_type_ = libmedia_codec::kVideoCodecH264;
 		uint8_t video_rtx_pt_ = 0;
+		// 对端answer中的flexfec-03 payload type, 0表示对端不支持
+		uint8_t video_flexfec_pt_ = 0;
 		uint8_t audio_pt_ = 0;
 		rtc::scoped_refptr<rtc::RTCCertificate> certificate_;
 		libice::IceParameters ice_param_;
@@ -130,8 +188,39 @@ namespace libp2p_peerconnection
 		uint16_t video_seq_ = 1000;
 		uint16_t audio_seq_ = 1000;
 		uint16_t  transprot_seq_ = 1000;
-
-		std::vector<std::shared_ptr<libmedia_transfer_protocol::RtpPacketToSend>> video_cache_;
+		// RTX流自己的序号空间, 重传包和padding共用, pacer线程分配
+		uint16_t  rtx_seq_ = 1000;
+
+		NackConfig                            video_nack_config_;
+		// 已发送的视频包, 用于响应NACK
+		std::unique_ptr<RtpPacketHistory>     video_history_;
+		// 对端支持flexfec时创建, 按丢包率生成FEC包
+		std::unique_ptr<FlexfecSender>        flexfec_sender_;
+		// 对端视频的收包/组帧, 注册在video transport的demuxer上
+		std::unique_ptr<RtpVideoStreamReceiver>  video_receiver_;
+		EncodedVideoFrameSinkInterface*       remote_video_sink_ = nullptr;
+		// video_receiver_创建前设置的jitter buffer参数
+		int                                   base_minimum_playout_delay_ms_ = 0;
+		bool                                  low_latency_mode_ = false;
+
+		// 每个发送流绑定的transport和它的generation, 网络线程更新, pacer线程读取;
+		// 网络线程先写transport再写generation, pacer先读generation再读transport,
+		// 读到新generation就一定读到新transport, 新旧混在一起的包在网络线程被丢弃
+		std::atomic<RtpTransportInternal*>    audio_rtp_transport_{ nullptr };
+		std::atomic<uint32_t>                 audio_rtp_transport_generation_{ 0 };
+		std::atomic<RtpTransportInternal*>    video_rtp_transport_{ nullptr };
+		std::atomic<uint32_t>                 video_rtp_transport_generation_{ 0 };
+		// 编码线程打包一帧时从transport_controller取的buffer, clear后保留容量
+		std::vector<rtc::CopyOnWriteBuffer>   video_packet_buffers_;
+		// pacer线程上一轮发送还没交给网络线程的包, clear后保留容量
+		std::vector<transport_controller::OutgoingRtpPacket>  send_burst_;
+		// 视频transport每个包在RTP之外的开销(IP/UDP/TURN/SRTP)
+		std::atomic<int>                      video_transport_overhead_;
+
+		// 音频包编码完成的时间, 按RTP序号存取: 编码线程写, pacer线程取出随包交给网络线程;
+		// slot里带序号, pacer积压超过kAudioEncodeTimeSlots个音频包时取不到(不统计)而不会取错
+		static constexpr size_t kAudioEncodeTimeSlots = 64;
+		std::array<std::atomic<uint64_t>, kAudioEncodeTimeSlots>  audio_encode_time_us_{};
 
 		std::unique_ptr< libmedia_transfer_protocol::RtpTransportControllerSend>    transport_send_;
 		//std::unique_ptr< libmedia_codec::I420Buffer>                     buffer_frame_;
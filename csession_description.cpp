@@ -57,6 +57,21 @@ namespace libp2p_peerconnection {
 		return acc.Release();
 	}
 
+static const char* DirectionToString(libmedia_transfer_protocol::RtpTransceiverDirection direction)
+{
+	switch (direction)
+	{
+	case libmedia_transfer_protocol::RtpTransceiverDirection::kSendRecv:
+		return "sendrecv";
+	case libmedia_transfer_protocol::RtpTransceiverDirection::kSendOnly:
+		return "sendonly";
+	case libmedia_transfer_protocol::RtpTransceiverDirection::kRecvOnly:
+		return "recvonly";
+	default:
+		return "inactive";
+	}
+}
+
 static void AddRtcpFbLine(const libmedia_transfer_protocol::Codec& codec,
 	std::stringstream& ss)
 {
@@ -79,6 +94,10 @@ static void AddFmtpLine(const libmedia_transfer_protocol::Codec& codec,
 	std::stringstream& ss)
 {
 
+	// VP8/AV1 etc. have no format parameters, an empty a=fmtp line is invalid
+	if (codec.params.empty()) {
+		return;
+	}
 	//for (const cricket::Codec &c : codecs)
 	{
 		// cricket::CodecParameterMap  params = codec.params;
@@ -130,7 +149,7 @@ inline void MediaContentDescriptionImpl<C>::BuildSsrc(MediaContentDescriptionImp
 				continue;
 			}
 
-			ss << "a=ssrc-group:FID";
+			ss << "a=ssrc-group:" << group.semantics;
 			for (auto ssrc : group.ssrcs) {
 				ss << " " << ssrc;
 			}
@@ -299,7 +318,12 @@ std::string SessionDescription::ToString()
 		}
 
 		ss << "a=mid:" << contents_[i].name << "\r\n";
-		ss << "a=" << "sendonly"/*GetDirection(content.media_description())*/ << "\r\n";
+		// a=extmap:3 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01
+		for (const libmedia_transfer_protocol::RtpExtension & extension : contents_[i].description_->rtp_header_extensions_)
+		{
+			ss << "a=extmap:" << extension.id << " " << extension.uri << "\r\n";
+		}
+		ss << "a=" << DirectionToString(contents_[i].description_->direction_) << "\r\n";
 		//if (content->rtcp_mux()) {
 		//	ss << "a=rtcp-mux" << "\r\n";
 		//}
@@ -29,8 +29,20 @@
 #include "libice/ice_credentials_iterator.h"
 #include "rtc_base/task_utils/to_queued_task.h"
 #include "libp2p_peerconnection/jsep_transport.h"
+#include "rtc_base/time_utils.h"
+#include <string.h>
 namespace libp2p_peerconnection
 {
+	// NACK, PLI, transport-cc等在这个窗口内合并成一个compound包,
+	// 只做一次SRTCP加密, 只发一个UDP包
+	static const int kRtcpCoalescingWindowMs = 5;
+	// compound包的最大长度, 加上IP/UDP/TURN头和SRTCP trailer不超过MTU
+	static const size_t kMaxCompoundRtcpPacketSize = 1200;
+	// RTCP公共头(4字节)加发送者SSRC, 也是不带report block的RR的长度
+	static const size_t kRtcpHeaderAndSsrcSize = 8;
+	static const uint8_t kRtcpSrPacketType = 200;
+	static const uint8_t kRtcpRrPacketType = 201;
+
 	transport_controller::transport_controller(  rtc::Thread*   t,   rtc::Thread* s
 		, rtc::BasicNetworkManager* default_network_manager,
 		libice::BasicPacketSocketFactory* default_socket_factory)
@@ -52,6 +64,7 @@ namespace libp2p_peerconnection
 		UpdateAggregateStates_n();
 	})
 		//, rtp_rtcp_impl_(nullptr)
+		, perf_stats_start_us_(rtc::TimeMicros())
 	{
 		 
 		if (network_thread_->IsCurrent())
@@ -103,11 +116,18 @@ namespace libp2p_peerconnection
 		{
 			return -1;
 		}
+		// BUNDLE组里第一个mid(bundle tag)创建transport, 组内其他mid共用; 不在组里的mid各自创建transport
+		const ContentGroup * bundle_group = desc->GetGroupByName("BUNDLE");
+		const std::string * bundle_tag = bundle_group ? bundle_group->FirstContentName() : nullptr;
+		if (bundle_group)
+		{
+			RTC_LOG(LS_INFO) << bundle_group->ToString();
+		}
 		for (size_t i = 0; i < desc->contents_.size(); ++i) {
 			std::string mid = desc->contents_[i].name;
 			//ContentInfo content = desc->contents_[i];
-			RTC_LOG(LS_INFO) << desc->content_groups_[0].ToString();
-			if (/*desc->HasGroup(mid) &&*/ mid != desc->contents_[0].name) {
+			const bool bundled = bundle_tag && bundle_group->HasContentName(mid);
+			if (bundled && mid != *bundle_tag) {
 				continue;
 			} 
 				// 创建ICE transport
@@ -152,7 +172,40 @@ namespace libp2p_peerconnection
 					jsep_transport->rtp_transport()->SignalRtcpPacketReceived.connect(
 						this, &transport_controller::OnRtcpPacketReceived_n);
 
+					// BUNDLE后组内所有m-line的包都走这个transport, 注册组内全部的a=extmap
+					RtpHeaderExtensions header_extensions;
+					for (const ContentInfo & content : desc->contents_)
+					{
+						const bool same_transport = bundled ? bundle_group->HasContentName(content.name)
+							: content.name == mid;
+						if (same_transport && content.description_)
+						{
+							header_extensions.insert(header_extensions.end(),
+								content.description_->rtp_header_extensions_.begin(),
+								content.description_->rtp_header_extensions_.end());
+						}
+					}
+					jsep_transport->rtp_transport()->UpdateRtpHeaderExtensionMap(header_extensions);
+
+					// 对端的带宽估计依赖我们回复的transport-cc反馈
+					auto feedback_generator = std::make_unique<TransportFeedbackGenerator>(network_thread_,
+						rtc::CreateRandomId(), [this, mid](rtc::CopyOnWriteBuffer packet) {
+						send_rtcp_packet(mid, std::move(packet));
+					});
+					jsep_transport->rtp_transport()->SignalTransportSequenceNumberReceived.connect(
+						feedback_generator.get(), &TransportFeedbackGenerator::OnPacketArrived);
+					feedback_generators_[mid] = std::move(feedback_generator);
+
+					JsepTransport * bundle_transport = jsep_transport.get();
 					transports_.RegisterTransport(desc->contents_[i].name, std::move(jsep_transport));
+					// BUNDLE的其他mid共用bundle tag的transport, 发送端和收包的demuxer按mid取transport
+					for (const ContentInfo & content : desc->contents_)
+					{
+						if (bundled && content.name != mid && bundle_group->HasContentName(content.name))
+						{
+							transports_.SetTransportForMid(content.name, bundle_transport);
+						}
+					}
 					UpdateAggregateStates_n();
 						 
 				});
@@ -193,7 +246,8 @@ namespace libp2p_peerconnection
 		for (size_t i = 0; i < desc->contents_.size(); ++i) {
 			std::string mid = desc->contents_[i].name;
 			//ContentInfo content = desc->contents_[i];
-			if (mid != desc->contents_[0].name/*desc->HasGroup(mid) && mid != desc->content_groups_[0].semantics_*/) {
+			// 只有自己创建了transport的mid(bundle tag或者不BUNDLE的mid)需要设置, 见set_remote_sdp
+			if (ices_.find(mid) == ices_.end()) {
 				continue;
 			}
 			libice::TransportInfo* td = desc->GetTransportInfoByName(mid); 
@@ -243,64 +297,369 @@ namespace libp2p_peerconnection
 	{
 		if (network_thread_->IsCurrent())
 		{ 
-			for (auto pi : ices_)
-			{
-				pi.second->AddRemoteCandidate(candidate);
-			} 
+			AddRemoteCandidate_n(candidate);
 		}
 		else
 		{
 			network_thread_->PostTask(ToQueuedTask(signaling_thread_safety_.flag(), [this, candidate]() {
 				RTC_DCHECK_RUN_ON(network_thread_);
-				for (auto pi : ices_)
-				{
-					pi.second->AddRemoteCandidate(candidate);
-				}
+				AddRemoteCandidate_n(candidate);
 			}));
 		}
 
 		
 		return 0;
 	}
+	void transport_controller::AddRemoteCandidate_n(const libice::Candidate & candidate)
+	{
+		// 不BUNDLE时每个mid有自己的ICE, candidate只加到所属mid的ICE;
+		// BUNDLE组内其他mid的candidate没有单独的ICE, 加到全部(只有bundle tag一个)
+		auto it = ices_.find(candidate.transport_name());
+		if (it != ices_.end())
+		{
+			it->second->AddRemoteCandidate(candidate);
+			return;
+		}
+		for (auto pi : ices_)
+		{
+			pi.second->AddRemoteCandidate(candidate);
+		}
+	}
 	int transport_controller::send_rtp_packet(const std::string & transport_name, const char * data, size_t len)
 	{
 	//	auto  * tr = &transports_;
-		rtc::CopyOnWriteBuffer buffer(data, len, 2048);// (len, len + 30);
-		network_thread_->PostTask(ToQueuedTask(signaling_thread_safety_.flag(), [this, buffer_ = std::move(buffer), transport_name_ = transport_name]()mutable {
+		// 裸指针接口需要一次拷贝, 调用方应尽量直接传buffer
+		copied_rtp_packets_.fetch_add(1, std::memory_order_relaxed);
+		rtc::CopyOnWriteBuffer buffer = PacketBufferPool::Current()->Acquire(data, len);
+		return send_rtp_packet(transport_name, std::move(buffer));
+	}
+	int transport_controller::send_rtp_packet(const std::string & transport_name, rtc::CopyOnWriteBuffer packet)
+	{
+		network_thread_->PostTask(ToQueuedTask(signaling_thread_safety_.flag(),
+			[this, transport_name, packet = std::move(packet)]() mutable {
 			RTC_DCHECK_RUN_ON(network_thread_);
-			
-			//rtc::PacketOptions  opts;
-			//ices_[transport_name]->SendPacket(data, len, opts, 0);
-			//return;
-			JsepTransport*  jsep_tran = transports_.GetTransportByName(transport_name_);
-			if (jsep_tran)
+			JsepTransport*  jsep_tran = transports_.GetTransportByName(transport_name);
+			if (jsep_tran && jsep_tran->rtp_transport())
 			{
-				//rtc::PacketOptions  opts;
-				
-				//buffer.SetData(data);
-				//buffer.SetSize(len + 30);
-				//buffer.SetData(std::string(data, len));
-				jsep_tran->rtp_transport()->SendRtpPacket(&buffer_, rtc::PacketOptions(), 1);
+				jsep_tran->rtp_transport()->SendRtpPacket(&packet, rtc::PacketOptions(), 1);
 			}
-			/*for (auto pi : ices_)
-			{
-				rtc::PacketOptions  opts;
-				pi.second->SendPacket(data, len, opts, 0);
-			}*/
+			PacketBufferPool::Current()->Release(std::move(packet));
 		}));
 		return 0;
 	}
+	int transport_controller::send_rtp_packet(RtpTransportInternal * rtp_transport, uint32_t transport_generation,
+		rtc::CopyOnWriteBuffer packet)
+	{
+		if (!rtp_transport)
+		{
+			return -1;
+		}
+		bool post_flush = false;
+		{
+			webrtc::MutexLock lock(&pending_rtp_lock_);
+			// 队列为空说明网络线程没有待处理的flush任务
+			post_flush = pending_rtp_packets_.empty();
+			pending_rtp_packets_.push_back({ rtp_transport, transport_generation, std::move(packet),
+				kTransportPerfLatencyEnabled ? rtc::TimeMicros() : 0, 0 });
+		}
+		if (post_flush)
+		{
+			PostFlushPendingRtpPackets();
+		}
+		return 0;
+	}
+	int transport_controller::send_rtp_packets(std::vector<OutgoingRtpPacket> * packets)
+	{
+		if (packets->empty())
+		{
+			return 0;
+		}
+		// 入队时间只用于延迟统计
+		const int64_t now_us = kTransportPerfLatencyEnabled ? rtc::TimeMicros() : 0;
+		bool post_flush = false;
+		{
+			webrtc::MutexLock lock(&pending_rtp_lock_);
+			post_flush = pending_rtp_packets_.empty();
+			pending_rtp_packets_.reserve(pending_rtp_packets_.size() + packets->size());
+			for (OutgoingRtpPacket & outgoing : *packets)
+			{
+				if (outgoing.rtp_transport)
+				{
+					pending_rtp_packets_.push_back({ outgoing.rtp_transport, outgoing.transport_generation,
+						std::move(outgoing.packet), now_us, outgoing.encode_time_us });
+				}
+			}
+		}
+		packets->clear();
+		if (post_flush)
+		{
+			PostFlushPendingRtpPackets();
+		}
+		return 0;
+	}
+	void transport_controller::PostFlushPendingRtpPackets()
+	{
+		network_thread_->PostTask(ToQueuedTask(signaling_thread_safety_.flag(), [this]() {
+			RTC_DCHECK_RUN_ON(network_thread_);
+			FlushPendingRtpPackets_n();
+		}));
+	}
+	void transport_controller::FlushPendingRtpPackets_n()
+	{
+		{
+			webrtc::MutexLock lock(&pending_rtp_lock_);
+			sending_rtp_packets_.swap(pending_rtp_packets_);
+		}
+		// 同一个transport的连续包一次加密(SrtpSession::ProtectRtpBatch)再依次发送, 每段只校验一次transport
+		const size_t num_packets = sending_rtp_packets_.size();
+		for (size_t begin = 0, end = 0; begin < num_packets; begin = end)
+		{
+			RtpTransportInternal * rtp_transport = sending_rtp_packets_[begin].rtp_transport;
+			const uint32_t transport_generation = sending_rtp_packets_[begin].transport_generation;
+			for (end = begin + 1; end < num_packets
+				&& sending_rtp_packets_[end].rtp_transport == rtp_transport
+				&& sending_rtp_packets_[end].transport_generation == transport_generation; ++end)
+			{
+			}
+			// 入队后transport可能已被替换销毁, 不再绑定或generation不一致时不能解引用;
+			// 其他没有变化的transport上的包照常发送
+			auto generation = rtp_transport_generations_.find(rtp_transport);
+			if (generation != rtp_transport_generations_.end() && generation->second == transport_generation)
+			{
+				send_run_.clear();
+				for (size_t i = begin; i < end; ++i)
+				{
+					send_run_.push_back(&sending_rtp_packets_[i].packet);
+				}
+				rtp_transport->SendRtpPackets(send_run_, rtc::PacketOptions(), 1);
+				// 每段最多读一次时钟: 打开延迟统计时, 或者段里有带编码时间的(音频)包
+				int64_t now_us = 0;
+				for (size_t i = begin; i < end; ++i)
+				{
+					const PendingRtpPacket & sent = sending_rtp_packets_[i];
+					++send_perf_counters_.packets;
+					send_perf_counters_.bytes += sent.packet.size();
+					if (!kTransportPerfLatencyEnabled && sent.encode_time_us == 0)
+					{
+						continue;
+					}
+					if (now_us == 0)
+					{
+						now_us = rtc::TimeMicros();
+					}
+					if (kTransportPerfLatencyEnabled)
+					{
+						send_perf_counters_.latency_us.Add(now_us - sent.enqueue_time_us);
+					}
+					if (sent.encode_time_us != 0)
+					{
+						encode_latency_us_.Add(now_us - sent.encode_time_us);
+					}
+				}
+			}
+		}
+		// socket已经拷贝了数据; 视频打包的大buffer还给编码线程用的send_buffer_pool_,
+		// 其他(音频, 裸指针接口)回收给网络线程的pool, 收包时复用
+		PacketBufferPool * pool = PacketBufferPool::Current();
+		{
+			webrtc::MutexLock lock(&send_buffer_pool_lock_);
+			for (PendingRtpPacket & pending : sending_rtp_packets_)
+			{
+				if (pending.packet.capacity() >= kRtpPacketBufferCapacity)
+				{
+					send_buffer_pool_.Release(std::move(pending.packet));
+				}
+				else
+				{
+					pool->Release(std::move(pending.packet));
+				}
+			}
+		}
+		// clear保留容量, 下一批复用
+		sending_rtp_packets_.clear();
+	}
+	void transport_controller::AcquireRtpSendBuffers(const uint8_t * header, size_t header_size, size_t capacity,
+		size_t count, std::vector<rtc::CopyOnWriteBuffer> * buffers)
+	{
+		webrtc::MutexLock lock(&send_buffer_pool_lock_);
+		for (size_t i = 0; i < count; ++i)
+		{
+			buffers->push_back(send_buffer_pool_.Acquire(header, header_size, capacity));
+		}
+	}
+	rtc::CopyOnWriteBuffer transport_controller::AcquireRtpSendBuffer(const uint8_t * header, size_t header_size,
+		size_t capacity)
+	{
+		webrtc::MutexLock lock(&send_buffer_pool_lock_);
+		return send_buffer_pool_.Acquire(header, header_size, capacity);
+	}
+	SrtpSendBufferStats transport_controller::GetRtpSendBufferStats_n()
+	{
+		RTC_DCHECK_RUN_ON(network_thread_);
+		SrtpSendBufferStats stats;
+		// 裸指针接口和history副本的拷贝; 裸指针接口的buffer来自PacketBufferPool, 分配次数见pool的miss统计
+		stats.copies = copied_rtp_packets_.load(std::memory_order_relaxed);
+		for (JsepTransport* jsep_tran : transports_.Transports())
+		{
+			RtpTransportInternal * rtp_transport = jsep_tran->rtp_transport();
+			// 只有SRTP transport有统计
+			if (!rtp_transport || !rtp_transport->IsSrtpActive())
+			{
+				continue;
+			}
+			const SrtpSendBufferStats & transport_stats =
+				static_cast<SrtpTransport*>(rtp_transport)->send_buffer_stats();
+			stats.packets += transport_stats.packets;
+			stats.allocations += transport_stats.allocations;
+			stats.copies += transport_stats.copies;
+		}
+		return stats;
+	}
+	TransportPerfSnapshot transport_controller::GetTransportPerfSnapshot_n()
+	{
+		RTC_DCHECK_RUN_ON(network_thread_);
+		TransportPerfSnapshot snapshot;
+		snapshot.elapsed_us = rtc::TimeMicros() - perf_stats_start_us_;
+		snapshot.send.Merge(send_perf_counters_);
+		snapshot.encode_to_wire_latency_us.Merge(encode_latency_us_);
+		for (JsepTransport* jsep_tran : transports_.Transports())
+		{
+			RtpTransportInternal * rtp_transport = jsep_tran->rtp_transport();
+			if (rtp_transport)
+			{
+				snapshot.receive.Merge(static_cast<RtpTransport*>(rtp_transport)->receive_perf_counters());
+			}
+		}
+		const SrtpSendBufferStats send_buffer_stats = GetRtpSendBufferStats_n();
+		snapshot.send_allocations = send_buffer_stats.allocations;
+		snapshot.send_copies = send_buffer_stats.copies;
+		snapshot.rtcp_packets = rtcp_packets_;
+		snapshot.rtcp_compound_packets = rtcp_compound_packets_;
+		// 收包buffer和发送回收的buffer都在网络线程的pool里
+		const PacketBufferPool::Stats & pool_stats = PacketBufferPool::Current()->stats();
+		snapshot.pool_hits = pool_stats.hits;
+		snapshot.pool_misses = pool_stats.misses;
+		snapshot.pool_high_water_mark = pool_stats.high_water_mark;
+		{
+			webrtc::MutexLock lock(&send_buffer_pool_lock_);
+			snapshot.send_pool_hits = send_buffer_pool_.stats().hits;
+			snapshot.send_pool_misses = send_buffer_pool_.stats().misses;
+		}
+		return snapshot;
+	}
+	const PacketLatencyHistogram & transport_controller::GetEncodeToWireLatency_n() const
+	{
+		RTC_DCHECK_RUN_ON(network_thread_);
+		return encode_latency_us_;
+	}
+	std::string transport_controller::GetTransportPerfStatsJson_n()
+	{
+		return TransportPerfSnapshotToJson(GetTransportPerfSnapshot_n());
+	}
 	int transport_controller::send_rtcp_packet(const std::string & transport_name, const char * data, size_t len)
 	{
+		rtc::CopyOnWriteBuffer buffer = PacketBufferPool::Current()->Acquire(data, len);
+		return send_rtcp_packet(transport_name, std::move(buffer));
+	}
+	int transport_controller::send_rtcp_packet(const std::string & transport_name, rtc::CopyOnWriteBuffer packet)
+	{
+		if (network_thread_->IsCurrent())
+		{
+			SendRtcpPacket_n(transport_name, std::move(packet));
+			return 0;
+		}
+		network_thread_->PostTask(ToQueuedTask(signaling_thread_safety_.flag(), [this, transport_name, packet = std::move(packet)]() mutable {
+			RTC_DCHECK_RUN_ON(network_thread_);
+			SendRtcpPacket_n(transport_name, std::move(packet));
+		}));
 		return 0;
 	}
+	void transport_controller::SendRtcpPacket_n(const std::string & transport_name, rtc::CopyOnWriteBuffer packet)
+	{
+		RTC_DCHECK_RUN_ON(network_thread_);
+		if (packet.size() < kRtcpHeaderAndSsrcSize)
+		{
+			RTC_LOG(LS_WARNING) << "drop invalid rtcp packet, size: " << packet.size();
+			return;
+		}
+		++rtcp_packets_;
+		rtc::CopyOnWriteBuffer & compound = pending_rtcp_packets_[transport_name];
+		if (!compound.empty() && compound.size() + packet.size() > kMaxCompoundRtcpPacketSize)
+		{
+			SendCompoundRtcpPacket_n(transport_name, &compound);
+		}
+		if (compound.empty())
+		{
+			const uint8_t packet_type = packet.cdata()[1];
+			if (packet_type == kRtcpSrPacketType || packet_type == kRtcpRrPacketType)
+			{
+				// 窗口内的第一个包直接作为compound包, 不拷贝
+				compound = std::move(packet);
+			}
+			else
+			{
+				// RFC 3550 6.1: 没有协商rtcp-rsize时compound包必须以SR/RR开头, SR/RR又不走这里
+				// (rtp_rtcp_impl_没有发送transport), feedback前面加一个空的RR;
+				// RR的SSRC用第一个包的发送者SSRC(公共头后面4字节)
+				uint8_t empty_rr[kRtcpHeaderAndSsrcSize] = { 0x80, kRtcpRrPacketType, 0x00, 0x01 };
+				memcpy(empty_rr + 4, packet.cdata() + 4, 4);
+				compound = PacketBufferPool::Current()->Acquire(empty_rr, sizeof(empty_rr));
+				compound.AppendData(packet.cdata(), packet.size());
+				PacketBufferPool::Current()->Release(std::move(packet));
+			}
+		}
+		else
+		{
+			compound.AppendData(packet.cdata(), packet.size());
+			PacketBufferPool::Current()->Release(std::move(packet));
+		}
+		if (!rtcp_flush_scheduled_)
+		{
+			rtcp_flush_scheduled_ = true;
+			network_thread_->PostDelayedTask(ToQueuedTask(signaling_thread_safety_.flag(), [this]() {
+				RTC_DCHECK_RUN_ON(network_thread_);
+				FlushPendingRtcpPackets_n();
+			}), kRtcpCoalescingWindowMs);
+		}
+	}
+	void transport_controller::FlushPendingRtcpPackets_n()
+	{
+		rtcp_flush_scheduled_ = false;
+		for (auto & name_compound : pending_rtcp_packets_)
+		{
+			if (!name_compound.second.empty())
+			{
+				SendCompoundRtcpPacket_n(name_compound.first, &name_compound.second);
+			}
+		}
+	}
+	void transport_controller::SendCompoundRtcpPacket_n(const std::string & transport_name, rtc::CopyOnWriteBuffer * compound)
+	{
+		// BUNDLE后按mid也能找到transport
+		JsepTransport*  jsep_tran = transports_.GetTransportForMid(transport_name);
+		RtpTransportInternal * rtp_transport = jsep_tran ? jsep_tran->rtp_transport() : nullptr;
+		if (rtp_transport)
+		{
+			// 同RTP, SRTCP保护后的包不再经过DTLS
+			rtp_transport->SendRtcpPacket(compound, rtc::PacketOptions(), 1);
+			++rtcp_compound_packets_;
+		}
+		else
+		{
+			RTC_LOG(LS_WARNING) << "send rtcp packet failed, not find transport: " << transport_name;
+		}
+		PacketBufferPool::Current()->Release(std::move(*compound));
+		compound->Clear();
+	}
 	void transport_controller::set_certificeate(rtc::scoped_refptr<rtc::RTCCertificate> cert)
 	{
 		certificate_ = cert;
 	}
 	bool transport_controller::OnTransportChanged(const std::string & mid, JsepTransport * transport)
 	{
-		RTC_LOG_F(LS_INFO) << "";
+		RTC_DCHECK_RUN_ON(network_thread_);
+		RTC_LOG_F(LS_INFO) << "mid: " << mid;
+		BindRtpTransport_n(mid, transport ? transport->rtp_transport() : nullptr);
 		//SignalRtcpPacketReceived();
 		/*if (config_.transport_observer) {
 			if (jsep_transport) {
@@ -314,7 +673,49 @@ namespace libp2p_peerconnection
 					nullptr, nullptr);
 			}
 		}*/
-		return false;
+		return true;
+	}
+	uint32_t transport_controller::BindRtpTransport_n(const std::string & mid, RtpTransportInternal * rtp_transport)
+	{
+		RTC_DCHECK_RUN_ON(network_thread_);
+		RtpTransportInternal * old_transport = nullptr;
+		auto bound = rtp_transport_by_mid_.find(mid);
+		if (bound != rtp_transport_by_mid_.end())
+		{
+			old_transport = bound->second;
+			rtp_transport_by_mid_.erase(bound);
+		}
+		if (rtp_transport)
+		{
+			rtp_transport_by_mid_[mid] = rtp_transport;
+		}
+		// 旧transport不再被任何mid绑定时移除, 发往它的包在flush时丢弃; 其他transport的generation不变
+		if (old_transport && old_transport != rtp_transport)
+		{
+			bool still_bound = false;
+			for (const auto & binding : rtp_transport_by_mid_)
+			{
+				still_bound = still_bound || binding.second == old_transport;
+			}
+			if (!still_bound)
+			{
+				rtp_transport_generations_.erase(old_transport);
+			}
+		}
+		uint32_t generation = 0;
+		if (rtp_transport)
+		{
+			// 已经绑定给其他mid(BUNDLE)的transport沿用原来的generation
+			auto inserted = rtp_transport_generations_.emplace(rtp_transport, next_rtp_transport_generation_);
+			if (inserted.second)
+			{
+				++next_rtp_transport_generation_;
+			}
+			generation = inserted.first->second;
+		}
+		// 通知发送流更新缓存的transport和generation
+		SignalRtpTransportChanged(mid, rtp_transport, generation);
+		return generation;
 	}
 	//void transport_controller::CreateVideoChannel(const libmedia_transfer_protocol::MediaConfig & media_config, 
 	//	RtpTransportInternal * rtp_transport, rtc::Thread * signaling_thread, rtc::Thread * worker_thread,
@@ -423,6 +824,8 @@ namespace libp2p_peerconnection
 		dtls_srtp_transport->SetDtlsTransports(rtp_dtls_transport,
 			rtcp_dtls_transport);
 		dtls_srtp_transport->SetActiveResetSrtpParams(active_reset_srtp_params_);
+		// 同一次socket读事件收到的RTP包在读事件结束时批量解密和分发
+		dtls_srtp_transport->SetInboundBatchingEnabled(true);
 		// Capturing this in the callback because JsepTransportController will always
 		// outlive the DtlsSrtpTransport.
 		dtls_srtp_transport->SetOnDtlsStateChange([this]() {
@@ -21,6 +21,7 @@
 
 #ifndef _C_TRANSPORT_CONNECTIONER_H_
 #define _C_TRANSPORT_CONNECTIONER_H_
+#include <atomic>
 #include "rtc_base/third_party/sigslot/sigslot.h"
 #include "libp2p_peerconnection/csession_description.h"
 #include "libice/ice_transport_interface.h"
@@ -29,10 +30,17 @@
 #include "libice/dtls_transport_internal.h"
 #include "libp2p_peerconnection/dtls_srtp_transport.h"
 #include "libp2p_peerconnection/jsep_transport_collection.h"
+#include "libp2p_peerconnection/packet_buffer_pool.h"
+#include "libp2p_peerconnection/transport_perf_stats.h"
+#include "libp2p_peerconnection/transport_feedback_generator.h"
 #include "libmedia_codec/video_bitrate_allocator_factory.h"
 #include "libmedia_transfer_protocol/rtp_rtcp/rtp_rtcp_impl.h"
+#include "rtc_base/synchronization/mutex.h"
 namespace libp2p_peerconnection
 {
+	// 发送RTP包的buffer容量, 留出SRTP auth tag的空间
+	static const size_t kRtpPacketBufferCapacity = PacketBufferPool::kLargeBufferCapacity;
+
 	class transport_controller : public sigslot::has_slots<>
 	{
 	public:
@@ -51,17 +59,61 @@ namespace libp2p_peerconnection
 
 		int set_remote_candidate(const libice::Candidate& candidate);
 
+		// pacer一轮发送的一个包, rtp_transport和transport_generation都由SignalRtpTransportChanged得到,
+		// 发送流先读generation再读transport
+		struct OutgoingRtpPacket
+		{
+			RtpTransportInternal *   rtp_transport;
+			uint32_t                 transport_generation;
+			rtc::CopyOnWriteBuffer   packet;
+			// 编码完成的时间(rtc::TimeMicros), 0表示不统计编码到发出的延迟
+			int64_t                  encode_time_us;
+		};
+		// 按名字发送: 每个包一次任务, 在网络线程上查找transport; 热路径用下面按transport发送的接口
 		int  send_rtp_packet(const std::string & transport_name, const char * data, size_t len);
+		int  send_rtp_packet(const std::string & transport_name, rtc::CopyOnWriteBuffer packet);
+		// 可在任意线程调用, 同一批次(网络线程还未处理前)的包只投递一次任务;
+		// 发送时不再按名字查找transport, 如果transport在网络线程处理前已不再绑定任何mid
+		// 或者generation不一致(同一地址上的新transport), 包被丢弃
+		int  send_rtp_packet(RtpTransportInternal * rtp_transport, uint32_t transport_generation,
+			rtc::CopyOnWriteBuffer packet);
+		// 一次性把pacer一轮发送的包交给网络线程, 加锁和投递任务各一次;
+		// 取走packets中的buffer, 清空后保留容量给下一轮
+		int  send_rtp_packets(std::vector<OutgoingRtpPacket> * packets);
 		int  send_rtcp_packet(const std::string& transport_name, const char * data, size_t len);
+		// 可在任意线程调用, 在网络线程上时直接发送
+		int  send_rtcp_packet(const std::string& transport_name, rtc::CopyOnWriteBuffer packet);
+
+		// 编码线程打包用: 取count个写好RTP头(header)的buffer, 容量不小于capacity;
+		// 网络线程发送后buffer回到这个pool, 每帧和每轮发送各加一次锁
+		void AcquireRtpSendBuffers(const uint8_t * header, size_t header_size, size_t capacity,
+			size_t count, std::vector<rtc::CopyOnWriteBuffer> * buffers);
+		// 同上, 取一个; RTX重传/padding包用, 可在任意线程调用
+		rtc::CopyOnWriteBuffer AcquireRtpSendBuffer(const uint8_t * header, size_t header_size, size_t capacity);
+		// 网络线程之外发送路径上的拷贝(NACK history/FEC的副本), 计入send_copies, 可在任意线程调用
+		void CountRtpPacketCopy() { copied_rtp_packets_.fetch_add(1, std::memory_order_relaxed); }
+		// 发送路径的内存分配/拷贝统计(所有transport汇总), 网络线程调用
+		SrtpSendBufferStats GetRtpSendBufferStats_n();
+		// 收发吞吐量/延迟/内存统计, 用于版本之间对比性能, 网络线程调用
+		TransportPerfSnapshot GetTransportPerfSnapshot_n();
+		std::string GetTransportPerfStatsJson_n();
+		// 带编码时间的包(音频)从编码完成到写入socket的延迟
+		const PacketLatencyHistogram & GetEncodeToWireLatency_n() const;
 
 		void set_certificeate(rtc::scoped_refptr<rtc::RTCCertificate> cert);
 
 		bool OnTransportChanged(const std::string& mid,
 			 JsepTransport* transport);
+		// 把mid绑定到rtp_transport(nullptr表示解绑)并触发SignalRtpTransportChanged, 返回transport的generation;
+		// OnTransportChanged经由这里绑定, bench也用它绑定自己的transport. 网络线程调用
+		uint32_t BindRtpTransport_n(const std::string & mid, RtpTransportInternal * rtp_transport);
 	public:
 		// Emitted whenever the new standards-compliant transport state changed.
 		sigslot::signal1<libice::IceTransportInternal*> SignalIceTransportStateChanged;
 		sigslot::signal2<rtc::CopyOnWriteBuffer*, int64_t> SignalRtcpPacketReceived;
+		// 协商后mid对应的RtpTransport变化(nullptr表示移除)和这个transport的generation, 网络线程触发;
+		// 发送流要和transport指针一起缓存generation, 随包交给send_rtp_packet(s)
+		sigslot::signal3<const std::string&, RtpTransportInternal*, uint32_t> SignalRtpTransportChanged;
 	public:
 
 		//void CreateVideoChannel(
@@ -139,6 +191,15 @@ namespace libp2p_peerconnection
 
 		void on_ice_stae();
 		void on_read_packet(const char * data, size_t len, int64_t ts);
+
+		// 网络线程上把待发送队列一次性发完
+		void FlushPendingRtpPackets_n();
+		void PostFlushPendingRtpPackets();
+		void AddRemoteCandidate_n(const libice::Candidate & candidate);
+		// RTCP包先追加到transport的compound包, 窗口结束或快满时一起发送
+		void SendRtcpPacket_n(const std::string & transport_name, rtc::CopyOnWriteBuffer packet);
+		void FlushPendingRtcpPackets_n();
+		void SendCompoundRtcpPacket_n(const std::string & transport_name, rtc::CopyOnWriteBuffer * compound);
 		//void on_ice_dtls_state(libice::IceDtlsTransportState ice_state);
 
 
@@ -168,6 +229,47 @@ namespace libp2p_peerconnection
 		JsepTransportCollection transports_ RTC_GUARDED_BY(network_thread_);
 		bool   active_reset_srtp_params_ = true;
 
+		// mid => 绑定的RtpTransport, 以及每个被绑定的transport的generation;
+		// transport第一次被绑定时分配新generation, 不再被任何mid绑定时移除.
+		// 入队的包按(transport, generation)判断transport是否还有效: 只丢弃发往被替换transport的包,
+		// 旧transport销毁后地址被新transport复用也不会误发
+		std::map<std::string, RtpTransportInternal*>  rtp_transport_by_mid_ RTC_GUARDED_BY(network_thread_);
+		std::map<RtpTransportInternal*, uint32_t>  rtp_transport_generations_ RTC_GUARDED_BY(network_thread_);
+		uint32_t  next_rtp_transport_generation_ RTC_GUARDED_BY(network_thread_) = 0;
+		// transport名字 => 收包的transport-cc反馈, 要在transports_之前析构
+		std::map<std::string, std::unique_ptr<TransportFeedbackGenerator>>  feedback_generators_ RTC_GUARDED_BY(network_thread_);
+
+		struct PendingRtpPacket
+		{
+			RtpTransportInternal *   rtp_transport;
+			uint32_t                 transport_generation;
+			rtc::CopyOnWriteBuffer   packet;
+			// 入队时间, 统计到写socket的延迟; 没有打开kTransportPerfLatencyEnabled时为0
+			int64_t                  enqueue_time_us;
+			int64_t                  encode_time_us;
+		};
+		// pacer线程写入, 网络线程取走; 两个vector交换复用内存
+		webrtc::Mutex                  pending_rtp_lock_;
+		std::vector<PendingRtpPacket>  pending_rtp_packets_ RTC_GUARDED_BY(pending_rtp_lock_);
+		std::vector<PendingRtpPacket>  sending_rtp_packets_ RTC_GUARDED_BY(network_thread_);
+		// 同一个transport的一段连续包, 交给SendRtpPackets
+		std::vector<rtc::CopyOnWriteBuffer*>  send_run_ RTC_GUARDED_BY(network_thread_);
+		// 网络线程之外的拷贝次数: 裸指针接口, 以及pacer线程给history/FEC的副本
+		std::atomic<int64_t>           copied_rtp_packets_{ 0 };
+		TransportPerfCounters          send_perf_counters_ RTC_GUARDED_BY(network_thread_);
+		PacketLatencyHistogram         encode_latency_us_ RTC_GUARDED_BY(network_thread_);
+		// 发送RTP包的buffer在编码线程取, 网络线程还; 线程各自的PacketBufferPool::Current()
+		// 只能在本线程复用, 所以两边共用一个加锁的pool
+		webrtc::Mutex                  send_buffer_pool_lock_;
+		PacketBufferPool               send_buffer_pool_ RTC_GUARDED_BY(send_buffer_pool_lock_);
+		int64_t                        perf_stats_start_us_ = 0;
+
+		// transport名字 => 窗口内待发送的compound RTCP包
+		std::map<std::string, rtc::CopyOnWriteBuffer>  pending_rtcp_packets_ RTC_GUARDED_BY(network_thread_);
+		bool                           rtcp_flush_scheduled_ RTC_GUARDED_BY(network_thread_) = false;
+		int64_t                        rtcp_packets_ RTC_GUARDED_BY(network_thread_) = 0;
+		int64_t                        rtcp_compound_packets_ RTC_GUARDED_BY(network_thread_) = 0;
+
 
 		//std::unique_ptr<libmedia_transfer_protocol::ModuleRtpRtcpImpl>   rtp_rtcp_impl_;
 	};
@@ -56,7 +56,7 @@ void DtlsSrtpTransport::SetDtlsTransports(
   // parameter even though the DtlsTransport may not change.
   if (IsSrtpActive() && (rtp_dtls_transport != rtp_dtls_transport_ ||
                          active_reset_srtp_params_)) {
-    ResetParams();
+    ResetParamsAndKeys();
   }
 
   const std::string transport_name =
@@ -166,25 +166,25 @@ void DtlsSrtpTransport::SetupRtpDtlsSrtp() {
     recv_extension_ids = *recv_extension_ids_;
   }
 
-  int selected_crypto_suite;
-  rtc::ZeroOnFreeBuffer<unsigned char> send_key;
-  rtc::ZeroOnFreeBuffer<unsigned char> recv_key;
-
-  if (!ExtractParams(rtp_dtls_transport_, &selected_crypto_suite, &send_key,
-                     &recv_key) ||
-      !SetRtpParams(selected_crypto_suite, &send_key[0],
-                    static_cast<int>(send_key.size()), send_extension_ids,
-                    selected_crypto_suite, &recv_key[0],
-                    static_cast<int>(recv_key.size()), recv_extension_ids)) {
+  // Updating the encrypted header extension IDs reuses the keys exported
+  // when the handshake completed instead of running the exporter again.
+  const ExportedSrtpKeys* keys =
+      GetOrExtractKeys(rtp_dtls_transport_, &rtp_keys_);
+  if (!keys ||
+      !SetRtpParams(keys->crypto_suite, keys->send_key.data(),
+                    static_cast<int>(keys->send_key.size()), send_extension_ids,
+                    keys->crypto_suite, keys->recv_key.data(),
+                    static_cast<int>(keys->recv_key.size()),
+                    recv_extension_ids)) {
     RTC_LOG(LS_WARNING) << "DTLS-SRTP key installation for RTP failed";
   }
 }
 
 void DtlsSrtpTransport::SetupRtcpDtlsSrtp() {
-  // Return if the DTLS-SRTP is active because the encrypted header extension
+  // Return if SRTCP is already set up because the encrypted header extension
   // IDs don't need to be updated for RTCP and the crypto params don't need to
   // be reset.
-  if (IsSrtpActive()) {
+  if (HasSrtcpSessions()) {
     return;
   }
 
@@ -197,20 +197,46 @@ void DtlsSrtpTransport::SetupRtcpDtlsSrtp() {
     recv_extension_ids = *recv_extension_ids_;
   }
 
-  int selected_crypto_suite;
-  rtc::ZeroOnFreeBuffer<unsigned char> rtcp_send_key;
-  rtc::ZeroOnFreeBuffer<unsigned char> rtcp_recv_key;
-  if (!ExtractParams(rtcp_dtls_transport_, &selected_crypto_suite,
-                     &rtcp_send_key, &rtcp_recv_key) ||
-      !SetRtcpParams(selected_crypto_suite, &rtcp_send_key[0],
-                     static_cast<int>(rtcp_send_key.size()), send_extension_ids,
-                     selected_crypto_suite, &rtcp_recv_key[0],
-                     static_cast<int>(rtcp_recv_key.size()),
+  const ExportedSrtpKeys* keys =
+      GetOrExtractKeys(rtcp_dtls_transport_, &rtcp_keys_);
+  if (!keys) {
+    RTC_LOG(LS_WARNING) << "DTLS-SRTP key installation for RTCP failed";
+    return;
+  }
+  // The RTCP DTLS association exports its own keys, so SRTCP can't reuse
+  // the RTP sessions. Their expanded key schedules can't be shared either:
+  // libsrtp keeps the cipher contexts inside each srtp_t and has no API to
+  // hand one to another session.
+  if (!SetRtcpParams(keys->crypto_suite, keys->send_key.data(),
+                     static_cast<int>(keys->send_key.size()),
+                     send_extension_ids, keys->crypto_suite,
+                     keys->recv_key.data(),
+                     static_cast<int>(keys->recv_key.size()),
                      recv_extension_ids)) {
     RTC_LOG(LS_WARNING) << "DTLS-SRTP key installation for RTCP failed";
   }
 }
 
+const DtlsSrtpTransport::ExportedSrtpKeys* DtlsSrtpTransport::GetOrExtractKeys(
+    libice::DtlsTransportInternal* dtls_transport,
+    absl::optional<ExportedSrtpKeys>* cache) {
+  if (!*cache) {
+    ExportedSrtpKeys keys;
+    if (!ExtractParams(dtls_transport, &keys.crypto_suite, &keys.send_key,
+                       &keys.recv_key)) {
+      return nullptr;
+    }
+    cache->emplace(std::move(keys));
+  }
+  return &**cache;
+}
+
+void DtlsSrtpTransport::ResetParamsAndKeys() {
+  rtp_keys_.reset();
+  rtcp_keys_.reset();
+  ResetParams();
+}
+
 bool DtlsSrtpTransport::ExtractParams(
 	libice::DtlsTransportInternal* dtls_transport,
     int* selected_crypto_suite,
@@ -283,6 +309,12 @@ void DtlsSrtpTransport::SetDtlsTransport(
   if (*old_dtls_transport == new_dtls_transport) {
     return;
   }
+  // Keys exported from the old association are no longer valid.
+  if (old_dtls_transport == &rtp_dtls_transport_) {
+    rtp_keys_.reset();
+  } else {
+    rtcp_keys_.reset();
+  }
 
   if (*old_dtls_transport) {
     (*old_dtls_transport)->UnsubscribeDtlsTransportState(this);
@@ -318,7 +350,7 @@ void DtlsSrtpTransport::OnDtlsState(libice::DtlsTransportInternal* transport,
   }
 
   if (state != libice::DtlsTransportState::kConnected) {
-    ResetParams();
+    ResetParamsAndKeys();
     return;
   }
 
@@ -86,6 +86,19 @@ class DtlsSrtpTransport : public SrtpTransport {
                      int* selected_crypto_suite,
                      rtc::ZeroOnFreeBuffer<unsigned char>* send_key,
                      rtc::ZeroOnFreeBuffer<unsigned char>* recv_key);
+
+  // SRTP keying material exported from one DTLS association.
+  struct ExportedSrtpKeys {
+    int crypto_suite = 0;
+    rtc::ZeroOnFreeBuffer<unsigned char> send_key;
+    rtc::ZeroOnFreeBuffer<unsigned char> recv_key;
+  };
+  // Runs the exporter only the first time for a given DTLS association;
+  // returns nullptr if the keys can't be extracted.
+  const ExportedSrtpKeys* GetOrExtractKeys(
+      libice::DtlsTransportInternal* dtls_transport,
+      absl::optional<ExportedSrtpKeys>* cache);
+  void ResetParamsAndKeys();
   void SetDtlsTransport(libice::DtlsTransportInternal* new_dtls_transport,
 	  libice::DtlsTransportInternal** old_dtls_transport);
   void SetRtpDtlsTransport(libice::DtlsTransportInternal* rtp_dtls_transport);
@@ -102,6 +115,11 @@ class DtlsSrtpTransport : public SrtpTransport {
   libice::DtlsTransportInternal* rtp_dtls_transport_ = nullptr;
   libice::DtlsTransportInternal* rtcp_dtls_transport_ = nullptr;
 
+  // Keys exported from `rtp_dtls_transport_` / `rtcp_dtls_transport_`, kept
+  // until the DTLS transport changes or leaves the connected state.
+  absl::optional<ExportedSrtpKeys> rtp_keys_;
+  absl::optional<ExportedSrtpKeys> rtcp_keys_;
+
   // The encrypted header extension IDs.
   absl::optional<std::vector<int>> send_extension_ids_;
   absl::optional<std::vector<int>> recv_extension_ids_;
@@ -20,14 +20,25 @@
 
 #include "libp2p_peerconnection/engine/unhandled_packets_buffer.h"
 
-#include "absl/algorithm/container.h"
+#include <utility>
+
+#include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
-#include "rtc_base/strings/string_builder.h"
 
 namespace libp2p_peerconnection {
 
-UnhandledPacketsBuffer::UnhandledPacketsBuffer() {
-  buffer_.reserve(kMaxStashedPackets);
+UnhandledPacketsBuffer::UnhandledPacketsBuffer()
+    : UnhandledPacketsBuffer(Config()) {}
+
+UnhandledPacketsBuffer::UnhandledPacketsBuffer(const Config& config)
+    : config_(config), buffer_(config.max_packets) {
+  RTC_DCHECK_GT(config_.max_packets, 0u);
+  // Every slot starts on the free list.
+  for (size_t i = 0; i < buffer_.size(); ++i) {
+    buffer_[i].next = i + 1 < buffer_.size() ? static_cast<int32_t>(i + 1)
+                                             : kNone;
+  }
+  free_ = buffer_.empty() ? kNone : 0;
 }
 
 UnhandledPacketsBuffer::~UnhandledPacketsBuffer() = default;
@@ -36,45 +47,132 @@ UnhandledPacketsBuffer::~UnhandledPacketsBuffer() = default;
 void UnhandledPacketsBuffer::AddPacket(uint32_t ssrc,
                                        int64_t packet_time_us,
                                        rtc::CopyOnWriteBuffer packet) {
-  if (buffer_.size() < kMaxStashedPackets) {
-    buffer_.push_back({ssrc, packet_time_us, packet});
+  if (packet.size() > config_.max_bytes) {
+    ++stats_.evicted_packets;
+    stats_.evicted_bytes += packet.size();
+    return;
+  }
+  while (free_ == kNone ||
+         stats_.stashed_bytes + packet.size() > config_.max_bytes) {
+    EvictOldest();
+  }
+
+  const int32_t index = free_;
+  PacketWithMetadata& entry = buffer_[index];
+  free_ = entry.next;
+  entry.ssrc = ssrc;
+  entry.packet_time_us = packet_time_us;
+  entry.arrival = next_arrival_++;
+  entry.prev = newest_;
+  entry.next = kNone;
+  entry.ssrc_next = kNone;
+  stats_.stashed_bytes += packet.size();
+  ++stats_.stashed_packets;
+  entry.packet = std::move(packet);
+
+  if (newest_ != kNone) {
+    buffer_[newest_].next = index;
   } else {
-    RTC_DCHECK_LT(insert_pos_, kMaxStashedPackets);
-    buffer_[insert_pos_] = {ssrc, packet_time_us, packet};
+    oldest_ = index;
   }
-  insert_pos_ = (insert_pos_ + 1) % kMaxStashedPackets;
+  newest_ = index;
+
+  SsrcChain& chain = chains_[ssrc];
+  if (chain.tail != kNone) {
+    buffer_[chain.tail].ssrc_next = index;
+  } else {
+    chain.head = index;
+  }
+  chain.tail = index;
 }
 
 // Backfill `consumer` with all stored packet related `ssrcs`.
 void UnhandledPacketsBuffer::BackfillPackets(
     rtc::ArrayView<const uint32_t> ssrcs,
     std::function<void(uint32_t, int64_t, rtc::CopyOnWriteBuffer)> consumer) {
-  size_t start;
-  if (buffer_.size() < kMaxStashedPackets) {
-    start = 0;
-  } else {
-    start = insert_pos_;
+  backfill_chains_.clear();
+  for (uint32_t ssrc : ssrcs) {
+    auto it = chains_.find(ssrc);
+    if (it != chains_.end()) {
+      backfill_chains_.push_back(&it->second);
+    }
   }
 
-  size_t count = 0;
-  std::vector<PacketWithMetadata> remaining;
-  remaining.reserve(kMaxStashedPackets);
-  for (size_t i = 0; i < buffer_.size(); ++i) {
-    const size_t pos = (i + start) % kMaxStashedPackets;
-
-    // One or maybe 2 ssrcs is expected => loop array instead of more elaborate
-    // scheme.
-    const uint32_t ssrc = buffer_[pos].ssrc;
-    if (absl::c_linear_search(ssrcs, ssrc)) {
-      ++count;
-      consumer(ssrc, buffer_[pos].packet_time_us, buffer_[pos].packet);
-    } else {
-      remaining.push_back(buffer_[pos]);
+  // One or maybe 2 ssrcs is expected => pick the oldest head by looping.
+  while (true) {
+    SsrcChain* oldest_chain = nullptr;
+    for (SsrcChain* chain : backfill_chains_) {
+      if (chain->head != kNone &&
+          (!oldest_chain || buffer_[chain->head].arrival <
+                                buffer_[oldest_chain->head].arrival)) {
+        oldest_chain = chain;
+      }
+    }
+    if (!oldest_chain) {
+      break;
     }
+    const int32_t index = oldest_chain->head;
+    const uint32_t ssrc = buffer_[index].ssrc;
+    const int64_t packet_time_us = buffer_[index].packet_time_us;
+    rtc::CopyOnWriteBuffer packet = RemoveChainHead(oldest_chain, index);
+    ++stats_.backfilled_packets;
+    consumer(ssrc, packet_time_us, std::move(packet));
   }
 
-  insert_pos_ = 0;  // insert_pos is only used when buffer is full.
-  buffer_.swap(remaining);
+  for (uint32_t ssrc : ssrcs) {
+    auto it = chains_.find(ssrc);
+    if (it != chains_.end() && it->second.head == kNone) {
+      chains_.erase(it);
+    }
+  }
+}
+
+rtc::CopyOnWriteBuffer UnhandledPacketsBuffer::RemoveChainHead(
+    SsrcChain* chain,
+    int32_t index) {
+  PacketWithMetadata& entry = buffer_[index];
+  RTC_DCHECK_EQ(chain->head, index);
+  chain->head = entry.ssrc_next;
+  if (chain->head == kNone) {
+    chain->tail = kNone;
+  }
+
+  if (entry.prev != kNone) {
+    buffer_[entry.prev].next = entry.next;
+  } else {
+    oldest_ = entry.next;
+  }
+  if (entry.next != kNone) {
+    buffer_[entry.next].prev = entry.prev;
+  } else {
+    newest_ = entry.prev;
+  }
+
+  stats_.stashed_bytes -= entry.packet.size();
+  --stats_.stashed_packets;
+  rtc::CopyOnWriteBuffer packet = std::move(entry.packet);
+  entry.packet = rtc::CopyOnWriteBuffer();
+  entry.prev = kNone;
+  entry.ssrc_next = kNone;
+  entry.next = free_;
+  free_ = index;
+  return packet;
+}
+
+void UnhandledPacketsBuffer::EvictOldest() {
+  RTC_DCHECK_NE(oldest_, kNone);
+  const int32_t index = oldest_;
+  const uint32_t ssrc = buffer_[index].ssrc;
+  ++stats_.evicted_packets;
+  stats_.evicted_bytes += buffer_[index].packet.size();
+
+  // The oldest packet overall is also the oldest of its SSRC.
+  auto it = chains_.find(ssrc);
+  RTC_DCHECK(it != chains_.end());
+  RemoveChainHead(&it->second, index);
+  if (it->second.head == kNone) {
+    chains_.erase(it);
+  }
 }
 
 }  // namespace cricket
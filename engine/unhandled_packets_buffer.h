@@ -21,43 +21,102 @@
 #ifndef _C_MEDIA_ENGINE_UNHANDLED_PACKETS_BUFFER_H_
 #define _C_MEDIA_ENGINE_UNHANDLED_PACKETS_BUFFER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <functional>
-#include <tuple>
-#include <utility>
+#include <unordered_map>
 #include <vector>
 
+#include "api/array_view.h"
 #include "rtc_base/copy_on_write_buffer.h"
 
 namespace libp2p_peerconnection {
 
+// Packets with an SSRC no stream is signaled for yet, kept until the stream
+// is created.
+//
+// Entries live in a slab sized once from Config::max_packets and are chained
+// per SSRC, oldest first, so backfilling costs the number of matching
+// packets and allocates nothing. When either the packet or the byte budget
+// is exceeded the oldest packets are evicted.
 class UnhandledPacketsBuffer {
  public:
-  // Visible for testing.
-  static constexpr size_t kMaxStashedPackets = 50;
+  // A simulcast publisher's 3 layers plus RTX arriving before signaling fill
+  // 50 packets in well under 100 ms; keep a few hundred milliseconds.
+  static constexpr size_t kDefaultMaxPackets = 512;
+  static constexpr size_t kDefaultMaxBytes = 1024 * 1024;
+
+  struct Config {
+    size_t max_packets = kDefaultMaxPackets;
+    size_t max_bytes = kDefaultMaxBytes;
+  };
+
+  struct Stats {
+    size_t stashed_packets = 0;
+    size_t stashed_bytes = 0;
+    int64_t evicted_packets = 0;
+    int64_t evicted_bytes = 0;
+    // Packets handed to a consumer by BackfillPackets().
+    int64_t backfilled_packets = 0;
+  };
 
   UnhandledPacketsBuffer();
+  explicit UnhandledPacketsBuffer(const Config& config);
   ~UnhandledPacketsBuffer();
 
+  UnhandledPacketsBuffer(const UnhandledPacketsBuffer&) = delete;
+  UnhandledPacketsBuffer& operator=(const UnhandledPacketsBuffer&) = delete;
+
   // Store packet in buffer.
   void AddPacket(uint32_t ssrc,
                  int64_t packet_time_us,
                  rtc::CopyOnWriteBuffer packet);
 
-  // Feed all packets with `ssrcs` into `consumer`.
+  // Feed all packets with `ssrcs` into `consumer`, in arrival order, and
+  // remove them. `consumer` must not add packets.
   void BackfillPackets(
       rtc::ArrayView<const uint32_t> ssrcs,
       std::function<void(uint32_t, int64_t, rtc::CopyOnWriteBuffer)> consumer);
 
+  const Stats& stats() const { return stats_; }
+
  private:
-  size_t insert_pos_ = 0;
+  static constexpr int32_t kNone = -1;
+
   struct PacketWithMetadata {
-    uint32_t ssrc;
-    int64_t packet_time_us;
+    uint32_t ssrc = 0;
+    int64_t packet_time_us = 0;
     rtc::CopyOnWriteBuffer packet;
+    // Arrival order across SSRCs, for merging the chains on backfill.
+    uint64_t arrival = 0;
+    // All packets, oldest first; the free list reuses `next`.
+    int32_t prev = kNone;
+    int32_t next = kNone;
+    // Next packet of the same SSRC.
+    int32_t ssrc_next = kNone;
+  };
+
+  struct SsrcChain {
+    int32_t head = kNone;
+    int32_t tail = kNone;
   };
+
+  // Unlinks the oldest packet of its SSRC chain, frees its slot and returns
+  // the packet.
+  rtc::CopyOnWriteBuffer RemoveChainHead(SsrcChain* chain, int32_t index);
+  void EvictOldest();
+
+  const Config config_;
   std::vector<PacketWithMetadata> buffer_;
+  int32_t oldest_ = kNone;
+  int32_t newest_ = kNone;
+  int32_t free_ = kNone;
+  uint64_t next_arrival_ = 0;
+  std::unordered_map<uint32_t, SsrcChain> chains_;
+  // Reused by every BackfillPackets().
+  std::vector<SsrcChain*> backfill_chains_;
+  Stats stats_;
 };
 
 }  // namespace cricket
@@ -1871,7 +1871,11 @@ void WebRtcVideoChannel::BackfillBufferedPackets(
                    << " packets for ssrcs: " << out.Release()
                    << " ok: " << delivery_ok_cnt
                    << " error: " << delivery_packet_error_cnt
-                   << " unknown: " << delivery_unknown_ssrc_cnt;
+                   << " unknown: " << delivery_unknown_ssrc_cnt
+                   << " still stashed: "
+                   << unknown_ssrc_packet_buffer_->stats().stashed_packets
+                   << " evicted: "
+                   << unknown_ssrc_packet_buffer_->stats().evicted_packets;
 }
 
 void WebRtcVideoChannel::OnReadyToSend(bool ready) {
@@ -1977,13 +1981,12 @@ bool WebRtcVideoChannel::SetBaseMinimumPlayoutDelayMs(uint32_t ssrc,
   RTC_DCHECK_RUN_ON(&thread_checker_);
   absl::optional<uint32_t> default_ssrc = GetDefaultReceiveStreamSsrc();
 
-  // SSRC of 0 represents the default receive stream.
-  if (ssrc == 0) {
-    default_recv_base_minimum_delay_ms_ = delay_ms;
-  }
-
+  // SSRC of 0 represents the default receive stream. The receive streams of
+  // this channel cannot apply the delay (see WebRtcVideoReceiveStream), so it
+  // is not remembered for a default stream created later either.
   if (ssrc == 0 && !default_ssrc) {
-    return true;
+    RTC_LOG(LS_WARNING) << "No default stream to set base minimum playout delay";
+    return false;
   }
 
   if (ssrc == 0 && default_ssrc) {
@@ -1992,7 +1995,12 @@ bool WebRtcVideoChannel::SetBaseMinimumPlayoutDelayMs(uint32_t ssrc,
 
   auto stream = receive_streams_.find(ssrc);
   if (stream != receive_streams_.end()) {
-    stream->second->SetBaseMinimumPlayoutDelayMs(delay_ms);
+    if (!stream->second->SetBaseMinimumPlayoutDelayMs(delay_ms)) {
+      return false;
+    }
+    if (stream->second->IsDefaultStream()) {
+      default_recv_base_minimum_delay_ms_ = delay_ms;
+    }
     return true;
   } else {
     RTC_LOG(LS_ERROR) << "No stream found to set base minimum playout delay";
@@ -3143,13 +3151,16 @@ void WebRtcVideoChannel::WebRtcVideoReceiveStream::SetFrameDecryptor(
 bool WebRtcVideoChannel::WebRtcVideoReceiveStream::SetBaseMinimumPlayoutDelayMs(
     int delay_ms) {
  /* return stream_ ? stream_->SetBaseMinimumPlayoutDelayMs(delay_ms) : false;*/
-	return false;
+  RTC_LOG(LS_WARNING) << "Base minimum playout delay is not supported on this "
+                         "stream, use p2p_peer_connection";
+  return false;
 }
 
-int WebRtcVideoChannel::WebRtcVideoReceiveStream::GetBaseMinimumPlayoutDelayMs()
+absl::optional<int>
+WebRtcVideoChannel::WebRtcVideoReceiveStream::GetBaseMinimumPlayoutDelayMs()
     const {
   //return stream_ ? stream_->GetBaseMinimumPlayoutDelayMs() : 0;
-	return 0;
+  return absl::nullopt;
 }
 
 void WebRtcVideoChannel::WebRtcVideoReceiveStream::SetSink(
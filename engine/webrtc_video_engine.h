@@ -476,9 +476,13 @@ class WebRtcVideoChannel : public libmedia_transfer_protocol::VideoMediaChannel,
     void SetFrameDecryptor(
         rtc::scoped_refptr<libmedia_transfer_protocol::FrameDecryptorInterface> frame_decryptor);
 
+    // No frame passes through this stream, so there is no jitter buffer to
+    // apply the delay to: Set fails and Get has nothing to report. The
+    // jitter buffer is controlled through
+    // p2p_peer_connection::SetBaseMinimumPlayoutDelayMs.
     bool SetBaseMinimumPlayoutDelayMs(int delay_ms);
 
-    int GetBaseMinimumPlayoutDelayMs() const;
+    absl::optional<int> GetBaseMinimumPlayoutDelayMs() const;
 
     void SetSink(libmedia_codec::VideoSinkInterface<libmedia_codec::VideoFrame>* sink);
 
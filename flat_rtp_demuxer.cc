@@ -0,0 +1,276 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/flat_rtp_demuxer.h"
+
+#include <algorithm>
+
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+constexpr size_t kInitialSsrcTableSize = 16;
+
+int Log2(size_t power_of_two) {
+  int bits = 0;
+  while ((size_t{1} << bits) < power_of_two) {
+    ++bits;
+  }
+  return bits;
+}
+
+}  // namespace
+
+FlatRtpDemuxer::FlatRtpDemuxer() {
+  payload_type_sinks_.fill(nullptr);
+  RehashSsrcTable(kInitialSsrcTableSize, nullptr);
+}
+
+FlatRtpDemuxer::~FlatRtpDemuxer() = default;
+
+bool FlatRtpDemuxer::AddSink(const webrtc::RtpDemuxerCriteria& criteria,
+                             webrtc::RtpPacketSinkInterface* sink) {
+  RTC_DCHECK(sink);
+  if (criteria.mid.empty() && criteria.rsid.empty() &&
+      criteria.ssrcs.empty() && criteria.payload_types.empty()) {
+    return false;
+  }
+
+  // Refuse criteria that would make routing ambiguous.
+  if (!criteria.mid.empty()) {
+    if (criteria.rsid.empty()) {
+      if (mid_sinks_.count(criteria.mid) != 0) {
+        return false;
+      }
+    } else if (mid_rsid_sinks_.count({criteria.mid, criteria.rsid}) != 0) {
+      return false;
+    }
+  } else if (!criteria.rsid.empty() && rsid_sinks_.count(criteria.rsid) != 0) {
+    return false;
+  }
+  for (uint32_t ssrc : criteria.ssrcs) {
+    const SsrcSlot* slot = FindSlot(ssrc);
+    if (slot && !slot->learned && slot->sink != sink) {
+      return false;
+    }
+  }
+
+  if (!criteria.mid.empty()) {
+    if (criteria.rsid.empty()) {
+      mid_sinks_[criteria.mid] = sink;
+    } else {
+      mid_rsid_sinks_[{criteria.mid, criteria.rsid}] = sink;
+    }
+  } else if (!criteria.rsid.empty()) {
+    rsid_sinks_[criteria.rsid] = sink;
+  }
+  for (uint32_t ssrc : criteria.ssrcs) {
+    BindSsrc(ssrc, sink, /*learned=*/false);
+  }
+  registrations_.push_back({sink, criteria});
+  if (!criteria.payload_types.empty()) {
+    RebuildPayloadTypeTable();
+  }
+  return true;
+}
+
+bool FlatRtpDemuxer::RemoveSink(const webrtc::RtpPacketSinkInterface* sink) {
+  RTC_DCHECK(sink);
+  auto is_sink = [sink](const Registration& registration) {
+    return registration.sink == sink;
+  };
+  auto it = std::remove_if(registrations_.begin(), registrations_.end(),
+                           is_sink);
+  if (it == registrations_.end()) {
+    return false;
+  }
+  registrations_.erase(it, registrations_.end());
+
+  auto erase_sink = [sink](auto& sink_map) {
+    for (auto map_it = sink_map.begin(); map_it != sink_map.end();) {
+      if (map_it->second == sink) {
+        map_it = sink_map.erase(map_it);
+      } else {
+        ++map_it;
+      }
+    }
+  };
+  erase_sink(mid_sinks_);
+  erase_sink(mid_rsid_sinks_);
+  erase_sink(rsid_sinks_);
+
+  // Linear probing can't simply clear a slot, rebuild the table instead.
+  // Removing sinks is rare compared to packets.
+  RehashSsrcTable(ssrc_table_.size(), sink);
+  RebuildPayloadTypeTable();
+  return true;
+}
+
+bool FlatRtpDemuxer::OnRtpPacket(const webrtc::RtpPacketReceived& packet) {
+  webrtc::RtpPacketSinkInterface* sink = FindSsrcSink(packet.Ssrc());
+  if (!sink) {
+    sink = ResolveSink(packet);
+    if (!sink) {
+      return false;
+    }
+  }
+  sink->OnRtpPacket(packet);
+  return true;
+}
+
+webrtc::RtpPacketSinkInterface* FlatRtpDemuxer::ResolveSink(
+    const webrtc::RtpPacketReceived& packet) {
+  webrtc::RtpPacketSinkInterface* sink = nullptr;
+
+  if (!mid_sinks_.empty() || !mid_rsid_sinks_.empty() || !rsid_sinks_.empty()) {
+    std::string mid;
+    std::string rsid;
+    packet.GetExtension<webrtc::RtpMid>(&mid);
+    if (!packet.GetExtension<webrtc::RtpStreamId>(&rsid)) {
+      packet.GetExtension<webrtc::RepairedRtpStreamId>(&rsid);
+    }
+    if (!mid.empty() && !rsid.empty()) {
+      auto it = mid_rsid_sinks_.find({mid, rsid});
+      if (it != mid_rsid_sinks_.end()) {
+        sink = it->second;
+      }
+    }
+    if (!sink && !mid.empty()) {
+      auto it = mid_sinks_.find(mid);
+      if (it != mid_sinks_.end()) {
+        sink = it->second;
+      }
+    }
+    if (!sink && !rsid.empty()) {
+      auto it = rsid_sinks_.find(rsid);
+      if (it != rsid_sinks_.end()) {
+        sink = it->second;
+      }
+    }
+  }
+
+  if (!sink) {
+    sink = payload_type_sinks_[packet.PayloadType() & 0x7F];
+  }
+
+  if (sink) {
+    if (learned_ssrc_count_ < kMaxLearnedSsrcBindings) {
+      BindSsrc(packet.Ssrc(), sink, /*learned=*/true);
+    } else {
+      RTC_LOG(LS_WARNING) << "New SSRC " << packet.Ssrc()
+                          << " not bound, too many learned SSRCs.";
+    }
+  }
+  return sink;
+}
+
+FlatRtpDemuxer::SsrcSlot* FlatRtpDemuxer::FindSlot(uint32_t ssrc) {
+  size_t index = SlotIndex(ssrc);
+  while (ssrc_table_[index].sink != nullptr) {
+    if (ssrc_table_[index].ssrc == ssrc) {
+      return &ssrc_table_[index];
+    }
+    index = (index + 1) & ssrc_mask_;
+  }
+  return nullptr;
+}
+
+void FlatRtpDemuxer::BindSsrc(uint32_t ssrc,
+                              webrtc::RtpPacketSinkInterface* sink,
+                              bool learned) {
+  SsrcSlot* slot = FindSlot(ssrc);
+  if (slot) {
+    if (learned && !slot->learned) {
+      return;
+    }
+    if (slot->learned && !learned) {
+      --learned_ssrc_count_;
+    }
+    slot->sink = sink;
+    slot->learned = learned;
+    return;
+  }
+
+  // Keep the load factor at or below 1/2 so that probe sequences stay short.
+  if ((ssrc_count_ + 1) * 2 > ssrc_table_.size()) {
+    RehashSsrcTable(ssrc_table_.size() * 2, nullptr);
+  }
+  size_t index = SlotIndex(ssrc);
+  while (ssrc_table_[index].sink != nullptr) {
+    index = (index + 1) & ssrc_mask_;
+  }
+  ssrc_table_[index] = {ssrc, sink, learned};
+  ++ssrc_count_;
+  if (learned) {
+    ++learned_ssrc_count_;
+  }
+}
+
+void FlatRtpDemuxer::RehashSsrcTable(
+    size_t capacity,
+    const webrtc::RtpPacketSinkInterface* removed_sink) {
+  RTC_DCHECK_EQ(capacity & (capacity - 1), 0u);
+  std::vector<SsrcSlot> old_table(capacity);
+  old_table.swap(ssrc_table_);
+  ssrc_mask_ = capacity - 1;
+  ssrc_shift_ = 32 - Log2(capacity);
+  ssrc_count_ = 0;
+  learned_ssrc_count_ = 0;
+  for (const SsrcSlot& slot : old_table) {
+    if (slot.sink == nullptr || slot.sink == removed_sink) {
+      continue;
+    }
+    size_t index = SlotIndex(slot.ssrc);
+    while (ssrc_table_[index].sink != nullptr) {
+      index = (index + 1) & ssrc_mask_;
+    }
+    ssrc_table_[index] = slot;
+    ++ssrc_count_;
+    if (slot.learned) {
+      ++learned_ssrc_count_;
+    }
+  }
+}
+
+void FlatRtpDemuxer::RebuildPayloadTypeTable() {
+  payload_type_sinks_.fill(nullptr);
+  std::array<bool, 128> ambiguous;
+  ambiguous.fill(false);
+  for (const Registration& registration : registrations_) {
+    for (uint8_t payload_type : registration.criteria.payload_types) {
+      payload_type &= 0x7F;
+      webrtc::RtpPacketSinkInterface*& entry = payload_type_sinks_[payload_type];
+      if (ambiguous[payload_type]) {
+        continue;
+      }
+      if (entry && entry != registration.sink) {
+        entry = nullptr;
+        ambiguous[payload_type] = true;
+        continue;
+      }
+      entry = registration.sink;
+    }
+  }
+}
+
+}  // namespace libp2p_peerconnection
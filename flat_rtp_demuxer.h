@@ -0,0 +1,145 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_FLAT_RTP_DEMUXER_H_
+#define _C_PC_FLAT_RTP_DEMUXER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "call/rtp_demuxer.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+
+namespace libp2p_peerconnection {
+
+// Receive side RTP demuxer tuned for high packet rates.
+//
+// Once a stream is known, routing a packet is a single probe into an open
+// addressed SSRC table (linear probing over a flat array, no allocation, no
+// pointer chasing). MID / RID header extensions and payload types are only
+// looked at for SSRCs that are not in the table yet; a match there binds the
+// SSRC so that later packets of the same stream take the fast path.
+//
+// Criteria semantics follow webrtc::RtpDemuxer: a sink can be registered by
+// MID, MID + RSID, RSID, SSRCs and payload types. A payload type shared by
+// more than one sink is ambiguous and is not used for routing.
+//
+// Not thread safe; RtpTransport uses it on the network thread only.
+class FlatRtpDemuxer {
+ public:
+  // Same limit as webrtc::RtpDemuxer for SSRCs learned from packets.
+  static constexpr size_t kMaxLearnedSsrcBindings = 1000;
+
+  FlatRtpDemuxer();
+  ~FlatRtpDemuxer();
+
+  FlatRtpDemuxer(const FlatRtpDemuxer&) = delete;
+  FlatRtpDemuxer& operator=(const FlatRtpDemuxer&) = delete;
+
+  // Returns false if the criteria is empty or conflicts with the criteria of
+  // another sink (same MID / MID + RSID / RSID, or an SSRC that is already
+  // explicitly registered).
+  bool AddSink(const webrtc::RtpDemuxerCriteria& criteria,
+               webrtc::RtpPacketSinkInterface* sink);
+
+  // Removes every criteria and learned SSRC of `sink`. Returns false if the
+  // sink was not registered.
+  bool RemoveSink(const webrtc::RtpPacketSinkInterface* sink);
+
+  // Delivers `packet` to its sink. Returns false if no sink matched.
+  bool OnRtpPacket(const webrtc::RtpPacketReceived& packet);
+
+  size_t num_ssrc_bindings() const { return ssrc_count_; }
+
+ private:
+  struct SsrcSlot {
+    uint32_t ssrc = 0;
+    // nullptr marks an empty slot.
+    webrtc::RtpPacketSinkInterface* sink = nullptr;
+    // Learned from MID/RID/payload type rather than registered explicitly.
+    bool learned = false;
+  };
+
+  struct Registration {
+    webrtc::RtpPacketSinkInterface* sink;
+    webrtc::RtpDemuxerCriteria criteria;
+  };
+
+  webrtc::RtpPacketSinkInterface* FindSsrcSink(uint32_t ssrc) const {
+    size_t index = SlotIndex(ssrc);
+    while (true) {
+      const SsrcSlot& slot = ssrc_table_[index];
+      if (slot.sink == nullptr) {
+        return nullptr;
+      }
+      if (slot.ssrc == ssrc) {
+        return slot.sink;
+      }
+      index = (index + 1) & ssrc_mask_;
+    }
+  }
+
+  size_t SlotIndex(uint32_t ssrc) const {
+    // Fibonacci hashing keeps sequentially chosen SSRCs apart.
+    return static_cast<uint32_t>(ssrc * 2654435761u) >> ssrc_shift_;
+  }
+
+  SsrcSlot* FindSlot(uint32_t ssrc);
+  // Inserts or overwrites the binding of `ssrc`. Explicit bindings are never
+  // overwritten by learned ones.
+  void BindSsrc(uint32_t ssrc,
+                webrtc::RtpPacketSinkInterface* sink,
+                bool learned);
+  void RehashSsrcTable(size_t capacity,
+                       const webrtc::RtpPacketSinkInterface* removed_sink);
+  void RebuildPayloadTypeTable();
+
+  // Slow path for SSRCs that are not bound yet.
+  webrtc::RtpPacketSinkInterface* ResolveSink(
+      const webrtc::RtpPacketReceived& packet);
+
+  std::vector<SsrcSlot> ssrc_table_;
+  size_t ssrc_mask_ = 0;
+  // 32 - log2(ssrc_table_.size()).
+  int ssrc_shift_ = 32;
+  size_t ssrc_count_ = 0;
+  size_t learned_ssrc_count_ = 0;
+
+  // Indexed by the 7 bit payload type, nullptr if unknown or ambiguous.
+  std::array<webrtc::RtpPacketSinkInterface*, 128> payload_type_sinks_;
+
+  std::map<std::string, webrtc::RtpPacketSinkInterface*> mid_sinks_;
+  std::map<std::pair<std::string, std::string>,
+           webrtc::RtpPacketSinkInterface*>
+      mid_rsid_sinks_;
+  std::map<std::string, webrtc::RtpPacketSinkInterface*> rsid_sinks_;
+
+  std::vector<Registration> registrations_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_FLAT_RTP_DEMUXER_H_
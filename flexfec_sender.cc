@@ -0,0 +1,245 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/flexfec_sender.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FEC_XOR_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FEC_XOR_NEON 1
+#endif
+
+#include "rtc_base/byte_io.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+constexpr size_t kRtpFixedHeaderSize = 12;
+// Base header, one SSRC, its sequence number base and a 15 bit mask.
+constexpr size_t kFlexfecHeaderSize = 20;
+constexpr size_t kSsrcCountOffset = 8;
+constexpr size_t kSsrcOffset = 12;
+constexpr size_t kSeqNumBaseOffset = 16;
+constexpr size_t kPacketMaskOffset = 18;
+// K bit: the mask ends after the first 15 bits.
+constexpr uint16_t kPacketMaskKBit = 0x8000;
+
+constexpr uint32_t kMsToRtpTimestamp = 90;
+constexpr size_t kFecPacketCapacity = 2048;
+
+// Loss above which FEC kicks in, the factor applied to the smoothed loss, and
+// the bounds of the resulting protection. A bit of extra bandwidth is cheaper
+// than the RTT a NACK costs.
+constexpr double kMinLossForFec = 0.01;
+constexpr double kLossToProtection = 2.0;
+constexpr double kMinProtection = 0.1;
+constexpr double kMaxProtection = 0.5;
+constexpr double kLossSmoothing = 0.3;
+
+}  // namespace
+
+void FecXorBytes(uint8_t* dst, const uint8_t* src, size_t size) {
+  size_t i = 0;
+#if defined(FEC_XOR_SSE2)
+  for (; i + 32 <= size; i += 32) {
+    __m128i d0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    __m128i d1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i + 16));
+    const __m128i s0 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i s1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_xor_si128(d0, s0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16),
+                     _mm_xor_si128(d1, s1));
+  }
+  for (; i + 16 <= size; i += 16) {
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(d, s));
+  }
+#elif defined(FEC_XOR_NEON)
+  for (; i + 32 <= size; i += 32) {
+    vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+    vst1q_u8(dst + i + 16,
+             veorq_u8(vld1q_u8(dst + i + 16), vld1q_u8(src + i + 16)));
+  }
+  for (; i + 16 <= size; i += 16) {
+    vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+  }
+#endif
+  for (; i < size; ++i) {
+    dst[i] ^= src[i];
+  }
+}
+
+size_t FlexfecSender::PacketOverhead(size_t rtp_header_size) {
+  // The FEC payload repeats everything after the media packet's fixed header.
+  return kFlexfecHeaderSize + rtp_header_size - kRtpFixedHeaderSize;
+}
+
+FlexfecSender::FlexfecSender(
+    int payload_type,
+    uint32_t ssrc,
+    uint32_t protected_media_ssrc,
+    const libmedia_transfer_protocol::RtpHeaderExtensionMap* extension_map)
+    : payload_type_(payload_type),
+      ssrc_(ssrc),
+      protected_media_ssrc_(protected_media_ssrc),
+      extension_map_(extension_map),
+      timestamp_offset_(rtc::CreateRandomId()),
+      sequence_number_(static_cast<uint16_t>(rtc::CreateRandomId())) {
+  media_packets_.reserve(kMaxMediaPacketsPerGroup);
+}
+
+FlexfecSender::~FlexfecSender() = default;
+
+void FlexfecSender::AddPacketToProtect(
+    const libmedia_transfer_protocol::RtpPacketToSend& packet) {
+  if (packet.Ssrc() != protected_media_ssrc_ ||
+      packet.size() < kRtpFixedHeaderSize) {
+    return;
+  }
+  // A group covers consecutive sequence numbers only.
+  if (!media_packets_.empty() &&
+      static_cast<uint16_t>(group_base_seq_ + media_packets_.size()) !=
+          packet.SequenceNumber()) {
+    GenerateFecPackets();
+  }
+  if (media_packets_.empty()) {
+    group_base_seq_ = packet.SequenceNumber();
+  }
+  media_packets_.push_back(packet.Buffer());
+  ++stats_.protected_packets;
+  if (packet.Marker() || media_packets_.size() == kMaxMediaPacketsPerGroup) {
+    GenerateFecPackets();
+  }
+}
+
+std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>>
+FlexfecSender::GetFecPackets() {
+  std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>>
+      fec_packets;
+  fec_packets.swap(fec_packets_);
+  return fec_packets;
+}
+
+void FlexfecSender::OnReceivedFractionLost(uint8_t fraction_lost) {
+  webrtc::MutexLock lock(&lock_);
+  smoothed_loss_ += kLossSmoothing * (fraction_lost / 256.0 - smoothed_loss_);
+  if (smoothed_loss_ < kMinLossForFec) {
+    protection_factor_ = 0.0;
+  } else {
+    protection_factor_ = std::min(
+        kMaxProtection,
+        std::max(kMinProtection, kLossToProtection * smoothed_loss_));
+  }
+}
+
+double FlexfecSender::protection_factor() const {
+  webrtc::MutexLock lock(&lock_);
+  return protection_factor_;
+}
+
+void FlexfecSender::GenerateFecPackets() {
+  const size_t num_media = media_packets_.size();
+  const size_t num_fec = std::min(
+      num_media,
+      static_cast<size_t>(std::ceil(num_media * protection_factor())));
+  const uint32_t timestamp =
+      timestamp_offset_ +
+      static_cast<uint32_t>(kMsToRtpTimestamp * rtc::TimeMillis());
+
+  for (size_t j = 0; j < num_fec; ++j) {
+    size_t max_payload_size = 0;
+    for (size_t i = j; i < num_media; i += num_fec) {
+      max_payload_size = std::max(max_payload_size,
+                                  media_packets_[i].size() - kRtpFixedHeaderSize);
+    }
+
+    auto fec_packet =
+        std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(
+            extension_map_, kFecPacketCapacity);
+    fec_packet->SetPayloadType(payload_type_);
+    fec_packet->SetSsrc(ssrc_);
+    fec_packet->SetSequenceNumber(sequence_number_++);
+    fec_packet->SetTimestamp(timestamp);
+    fec_packet->SetMarker(false);
+    fec_packet->ReserveExtension<
+        libmedia_transfer_protocol::TransportSequenceNumber>();
+    fec_packet->set_packet_type(
+        libmedia_transfer_protocol::RtpPacketMediaType::kForwardErrorCorrection);
+    uint8_t* fec =
+        fec_packet->AllocatePayload(kFlexfecHeaderSize + max_payload_size);
+    if (!fec) {
+      RTC_LOG(LS_WARNING) << "FlexFEC packet too large: "
+                          << kFlexfecHeaderSize + max_payload_size;
+      break;
+    }
+    memset(fec, 0, kFlexfecHeaderSize + max_payload_size);
+
+    // XOR of the media headers' first two bytes, payload lengths and
+    // timestamps goes into the FEC header, the rest into the FEC payload.
+    uint16_t length_recovery = 0;
+    uint16_t packet_mask = 0;
+    for (size_t i = j; i < num_media; i += num_fec) {
+      const uint8_t* media = media_packets_[i].cdata();
+      const size_t media_payload_size =
+          media_packets_[i].size() - kRtpFixedHeaderSize;
+      fec[0] ^= media[0];
+      fec[1] ^= media[1];
+      length_recovery ^= static_cast<uint16_t>(media_payload_size);
+      FecXorBytes(fec + 4, media + 4, 4);
+      FecXorBytes(fec + kFlexfecHeaderSize, media + kRtpFixedHeaderSize,
+                  media_payload_size);
+      packet_mask |= static_cast<uint16_t>(1 << (14 - i));
+    }
+    // Clear the R and F bits.
+    fec[0] &= 0x3f;
+    webrtc::ByteWriter<uint16_t>::WriteBigEndian(fec + 2, length_recovery);
+    fec[kSsrcCountOffset] = 1;
+    webrtc::ByteWriter<uint32_t>::WriteBigEndian(fec + kSsrcOffset,
+                                                 protected_media_ssrc_);
+    webrtc::ByteWriter<uint16_t>::WriteBigEndian(fec + kSeqNumBaseOffset,
+                                                 group_base_seq_);
+    webrtc::ByteWriter<uint16_t>::WriteBigEndian(
+        fec + kPacketMaskOffset, kPacketMaskKBit | packet_mask);
+
+    ++stats_.fec_packets;
+    stats_.fec_bytes += fec_packet->size();
+    fec_packets_.push_back(std::move(fec_packet));
+  }
+  media_packets_.clear();
+}
+
+}  // namespace libp2p_peerconnection
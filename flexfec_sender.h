@@ -0,0 +1,119 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_FLEXFEC_SENDER_H_
+#define _C_PC_FLEXFEC_SENDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "libmedia_transfer_protocol/rtp_rtcp/rtp_header_extension_map.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtp_packet_to_send.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace libp2p_peerconnection {
+
+// XORs `size` bytes of `src` into `dst`, 16 bytes at a time with SSE2 or
+// NEON when the target has them.
+void FecXorBytes(uint8_t* dst, const uint8_t* src, size_t size);
+
+// Generates FlexFEC (draft-ietf-payload-flexible-fec-scheme-03, the version
+// implemented by libwebrtc) packets for one media SSRC.
+//
+// Media packets are grouped per frame, in runs of at most
+// kMaxMediaPacketsPerGroup consecutive sequence numbers so the packet mask
+// always fits the short 15 bit form. Each group gets
+// ceil(group size * protection factor) FEC packets, interleaved so that
+// FEC packet j covers media packets j, j + m, j + 2m, ... which recovers a
+// burst of up to m consecutive losses.
+//
+// AddPacketToProtect() and GetFecPackets() are called on the pacer thread;
+// OnReceivedFractionLost() may be called on any thread.
+class FlexfecSender {
+ public:
+  static constexpr size_t kMaxMediaPacketsPerGroup = 15;
+
+  // How much larger a FEC packet is than the largest media packet it
+  // protects, when both carry `rtp_header_size` bytes of RTP header.
+  static size_t PacketOverhead(size_t rtp_header_size);
+
+  struct Stats {
+    int64_t protected_packets = 0;
+    int64_t fec_packets = 0;
+    int64_t fec_bytes = 0;
+  };
+
+  FlexfecSender(
+      int payload_type,
+      uint32_t ssrc,
+      uint32_t protected_media_ssrc,
+      const libmedia_transfer_protocol::RtpHeaderExtensionMap* extension_map);
+  ~FlexfecSender();
+
+  FlexfecSender(const FlexfecSender&) = delete;
+  FlexfecSender& operator=(const FlexfecSender&) = delete;
+
+  uint32_t ssrc() const { return ssrc_; }
+
+  // Keeps a reference to the packet's buffer until its group is complete.
+  // Packets of other SSRCs are ignored.
+  void AddPacketToProtect(
+      const libmedia_transfer_protocol::RtpPacketToSend& packet);
+
+  // Returns the FEC packets generated since the last call.
+  std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>>
+  GetFecPackets();
+
+  // `fraction_lost` as reported in an RTCP report block (Q8).
+  void OnReceivedFractionLost(uint8_t fraction_lost);
+
+  double protection_factor() const;
+  const Stats& stats() const { return stats_; }
+
+ private:
+  void GenerateFecPackets();
+
+  const int payload_type_;
+  const uint32_t ssrc_;
+  const uint32_t protected_media_ssrc_;
+  const libmedia_transfer_protocol::RtpHeaderExtensionMap* const
+      extension_map_;
+  const uint32_t timestamp_offset_;
+  uint16_t sequence_number_;
+
+  // Media packets of the current group, starting at `group_base_seq_`.
+  std::vector<rtc::CopyOnWriteBuffer> media_packets_;
+  uint16_t group_base_seq_ = 0;
+  std::vector<std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>>
+      fec_packets_;
+  Stats stats_;
+
+  mutable webrtc::Mutex lock_;
+  double protection_factor_ RTC_GUARDED_BY(lock_) = 0.0;
+  double smoothed_loss_ RTC_GUARDED_BY(lock_) = 0.0;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_FLEXFEC_SENDER_H_
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/h264_rtp_depacketizer.h"
+
+#include <string.h>
+
+#include "rtc_base/byte_io.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+constexpr uint8_t kNalTypeMask = 0x1f;
+constexpr uint8_t kNalHeaderMask = 0xe0;
+constexpr uint8_t kIdr = 5;
+constexpr uint8_t kSps = 7;
+constexpr uint8_t kPps = 8;
+constexpr uint8_t kStapA = 24;
+constexpr uint8_t kFuA = 28;
+constexpr uint8_t kFuStartBit = 0x80;
+
+constexpr size_t kStartCodeSize = 4;
+constexpr uint8_t kStartCode[kStartCodeSize] = {0, 0, 0, 1};
+constexpr size_t kStapALengthSize = 2;
+constexpr size_t kFuAHeaderSize = 2;
+
+void AddNalType(uint8_t nal_type, H264PayloadInfo* info) {
+  info->has_sps |= nal_type == kSps;
+  info->has_pps |= nal_type == kPps;
+  info->has_idr |= nal_type == kIdr;
+}
+
+}  // namespace
+
+bool ParseH264Payload(const uint8_t* payload,
+                      size_t size,
+                      H264PayloadInfo* info) {
+  *info = H264PayloadInfo();
+  if (size == 0) {
+    return false;
+  }
+  const uint8_t nal_type = payload[0] & kNalTypeMask;
+  if (nal_type >= 1 && nal_type < kStapA) {
+    info->starts_nalu = true;
+    AddNalType(nal_type, info);
+    info->annexb_size = kStartCodeSize + size;
+    return true;
+  }
+  if (nal_type == kStapA) {
+    info->starts_nalu = true;
+    size_t offset = 1;
+    while (offset + kStapALengthSize <= size) {
+      const size_t nalu_size =
+          webrtc::ByteReader<uint16_t>::ReadBigEndian(payload + offset);
+      offset += kStapALengthSize;
+      if (nalu_size == 0 || offset + nalu_size > size) {
+        return false;
+      }
+      AddNalType(payload[offset] & kNalTypeMask, info);
+      info->annexb_size += kStartCodeSize + nalu_size;
+      offset += nalu_size;
+    }
+    return offset == size && info->annexb_size > 0;
+  }
+  if (nal_type == kFuA) {
+    if (size <= kFuAHeaderSize) {
+      return false;
+    }
+    const uint8_t fu_header = payload[1];
+    info->starts_nalu = (fu_header & kFuStartBit) != 0;
+    if (info->starts_nalu) {
+      AddNalType(fu_header & kNalTypeMask, info);
+      // Start code and the reconstructed NAL unit header.
+      info->annexb_size = kStartCodeSize + 1;
+    }
+    info->annexb_size += size - kFuAHeaderSize;
+    return true;
+  }
+  return false;
+}
+
+void WriteH264AnnexB(const uint8_t* payload, size_t size, uint8_t* dst) {
+  const uint8_t nal_type = payload[0] & kNalTypeMask;
+  if (nal_type == kStapA) {
+    size_t offset = 1;
+    while (offset + kStapALengthSize <= size) {
+      const size_t nalu_size =
+          webrtc::ByteReader<uint16_t>::ReadBigEndian(payload + offset);
+      offset += kStapALengthSize;
+      memcpy(dst, kStartCode, kStartCodeSize);
+      memcpy(dst + kStartCodeSize, payload + offset, nalu_size);
+      dst += kStartCodeSize + nalu_size;
+      offset += nalu_size;
+    }
+  } else if (nal_type == kFuA) {
+    const uint8_t fu_header = payload[1];
+    if (fu_header & kFuStartBit) {
+      memcpy(dst, kStartCode, kStartCodeSize);
+      dst[kStartCodeSize] =
+          (payload[0] & kNalHeaderMask) | (fu_header & kNalTypeMask);
+      dst += kStartCodeSize + 1;
+    }
+    memcpy(dst, payload + kFuAHeaderSize, size - kFuAHeaderSize);
+  } else {
+    memcpy(dst, kStartCode, kStartCodeSize);
+    memcpy(dst + kStartCodeSize, payload, size);
+  }
+}
+
+}  // namespace libp2p_peerconnection
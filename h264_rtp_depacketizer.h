@@ -0,0 +1,54 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_H264_RTP_DEPACKETIZER_H_
+#define _C_PC_H264_RTP_DEPACKETIZER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace libp2p_peerconnection {
+
+// What an H.264 RTP payload (RFC 6184: single NAL unit, STAP-A or FU-A)
+// contains, found by looking at the NAL unit headers only.
+struct H264PayloadInfo {
+  // The payload starts a NAL unit, i.e. is not a middle or last FU-A
+  // fragment.
+  bool starts_nalu = false;
+  bool has_sps = false;
+  bool has_pps = false;
+  bool has_idr = false;
+  // Size of the payload converted to Annex B (start codes instead of the
+  // STAP-A lengths, FU-A headers replaced by the NAL unit header).
+  size_t annexb_size = 0;
+};
+
+// Returns false for malformed payloads and for the packetization modes
+// libwebrtc does not send (STAP-B, MTAP, FU-B).
+bool ParseH264Payload(const uint8_t* payload,
+                      size_t size,
+                      H264PayloadInfo* info);
+
+// Writes the Annex B form of a payload accepted by ParseH264Payload(),
+// exactly `info.annexb_size` bytes, to `dst`.
+void WriteH264AnnexB(const uint8_t* payload, size_t size, uint8_t* dst);
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_H264_RTP_DEPACKETIZER_H_
@@ -0,0 +1,245 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/nack_requester.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+#include "rtc_base/time_utils.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+// Keeps unwrapped sequence numbers positive when the first packets arrive
+// out of order.
+constexpr int64_t kFirstSequenceNumberBase = 1 << 16;
+
+}  // namespace
+
+NackRequester::NackRequester(rtc::Thread* network_thread,
+                             NackSender nack_sender,
+                             KeyFrameRequester keyframe_requester)
+    : network_thread_(network_thread),
+      nack_sender_(std::move(nack_sender)),
+      keyframe_requester_(std::move(keyframe_requester)) {
+  RTC_DCHECK(network_thread_);
+  RTC_DCHECK(nack_sender_);
+  RTC_DCHECK(keyframe_requester_);
+  nack_batch_.reserve(kMaxMissingPackets);
+}
+
+NackRequester::~NackRequester() = default;
+
+void NackRequester::OnReceivedPacket(uint32_t media_ssrc,
+                                     uint16_t sequence_number,
+                                     int64_t now_ms) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  Stream* stream = GetStream(media_ssrc, now_ms);
+  stream->last_receive_time_ms = now_ms;
+  if (stream->newest_sequence_number < 0) {
+    stream->newest_sequence_number = kFirstSequenceNumberBase + sequence_number;
+    return;
+  }
+
+  const int64_t unwrapped = Unwrap(*stream, sequence_number);
+  if (unwrapped <= stream->newest_sequence_number) {
+    const size_t index = static_cast<size_t>(unwrapped) & kIndexMask;
+    if (stream->newest_sequence_number - unwrapped <
+            static_cast<int64_t>(kMaxPacketAge) &&
+        stream->missing[index]) {
+      stream->missing[index] = false;
+      --stream->missing_count;
+      if (stream->retries[index] > 0) {
+        ++stats_.recovered_packets;
+      } else {
+        ++stats_.reordered_packets;
+      }
+    }
+    return;
+  }
+
+  const size_t gap =
+      static_cast<size_t>(unwrapped - stream->newest_sequence_number - 1);
+  if (stream->missing_count + gap > kMaxMissingPackets) {
+    RTC_LOG(LS_WARNING) << "NACK list full for ssrc " << media_ssrc
+                        << ", dropping " << stream->missing_count + gap
+                        << " missing packets.";
+    stats_.lost_packets += stream->missing_count + gap;
+    Clear(stream);
+    stream->newest_sequence_number = unwrapped;
+    keyframe_requester_(media_ssrc);
+    return;
+  }
+
+  bool expired = false;
+  for (int64_t i = stream->newest_sequence_number + 1; i <= unwrapped; ++i) {
+    const size_t index = static_cast<size_t>(i) & kIndexMask;
+    // The slot still holds the packet kMaxPacketAge before, never received.
+    if (stream->missing[index]) {
+      --stream->missing_count;
+      ++stats_.lost_packets;
+      expired = true;
+    }
+    stream->missing[index] = i != unwrapped;
+    stream->retries[index] = 0;
+    stream->request_time_ms[index] = -1;
+  }
+  stream->missing_count += gap;
+  stream->newest_sequence_number = unwrapped;
+
+  if (expired) {
+    keyframe_requester_(media_ssrc);
+  }
+  if (stream->missing_count > 0) {
+    ScheduleProcess();
+  }
+}
+
+void NackRequester::ClearUpTo(uint32_t media_ssrc, uint16_t sequence_number) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  auto it = streams_.find(media_ssrc);
+  if (it == streams_.end() || it->second.missing_count == 0) {
+    return;
+  }
+  Stream& stream = it->second;
+  const int64_t end =
+      std::min(Unwrap(stream, sequence_number), stream.newest_sequence_number);
+  for (int64_t i = OldestTracked(stream);
+       i < end && stream.missing_count > 0; ++i) {
+    const size_t index = static_cast<size_t>(i) & kIndexMask;
+    if (stream.missing[index]) {
+      stream.missing[index] = false;
+      --stream.missing_count;
+    }
+  }
+}
+
+void NackRequester::UpdateRtt(int64_t rtt_ms) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (rtt_ms > 0) {
+    rtt_ms_ = rtt_ms;
+  }
+}
+
+NackRequester::Stream* NackRequester::GetStream(uint32_t media_ssrc,
+                                                int64_t now_ms) {
+  auto it = streams_.find(media_ssrc);
+  if (it != streams_.end()) {
+    return &it->second;
+  }
+  if (streams_.size() >= kMaxStreams) {
+    // Make room by forgetting the stream that has been quiet the longest.
+    auto oldest = std::min_element(
+        streams_.begin(), streams_.end(), [](const auto& a, const auto& b) {
+          return a.second.last_receive_time_ms < b.second.last_receive_time_ms;
+        });
+    streams_.erase(oldest);
+  }
+  Stream& stream = streams_[media_ssrc];
+  stream.last_receive_time_ms = now_ms;
+  return &stream;
+}
+
+int64_t NackRequester::Unwrap(const Stream& stream, uint16_t sequence_number) {
+  const int16_t delta = static_cast<int16_t>(static_cast<uint16_t>(
+      sequence_number - static_cast<uint16_t>(stream.newest_sequence_number)));
+  return stream.newest_sequence_number + delta;
+}
+
+int64_t NackRequester::OldestTracked(const Stream& stream) {
+  return std::max<int64_t>(
+      stream.newest_sequence_number - static_cast<int64_t>(kMaxPacketAge) + 1,
+      0);
+}
+
+void NackRequester::Clear(Stream* stream) {
+  stream->missing.reset();
+  stream->missing_count = 0;
+}
+
+void NackRequester::ScheduleProcess() {
+  if (process_scheduled_) {
+    return;
+  }
+  process_scheduled_ = true;
+  network_thread_->PostDelayedTask(
+      webrtc::ToQueuedTask(task_safety_,
+                           [this]() {
+                             RTC_DCHECK_RUN_ON(network_thread_);
+                             process_scheduled_ = false;
+                             Process(rtc::TimeMillis());
+                           }),
+      kProcessIntervalMs);
+}
+
+void NackRequester::Process(int64_t now_ms) {
+  bool missing = false;
+  for (auto& ssrc_stream : streams_) {
+    const uint32_t media_ssrc = ssrc_stream.first;
+    Stream& stream = ssrc_stream.second;
+    if (stream.missing_count == 0) {
+      continue;
+    }
+
+    bool given_up = false;
+    nack_batch_.clear();
+    // Oldest first, which is also the order the NACK packs them in.
+    for (int64_t i = OldestTracked(stream); i < stream.newest_sequence_number;
+         ++i) {
+      const size_t index = static_cast<size_t>(i) & kIndexMask;
+      if (!stream.missing[index]) {
+        continue;
+      }
+      if (stream.request_time_ms[index] >= 0 &&
+          now_ms - stream.request_time_ms[index] < rtt_ms_) {
+        continue;
+      }
+      if (stream.retries[index] >= kMaxRetries) {
+        stream.missing[index] = false;
+        --stream.missing_count;
+        ++stats_.lost_packets;
+        given_up = true;
+        continue;
+      }
+      ++stream.retries[index];
+      stream.request_time_ms[index] = now_ms;
+      nack_batch_.push_back(static_cast<uint16_t>(i));
+    }
+
+    if (!nack_batch_.empty()) {
+      ++stats_.nack_packets;
+      stats_.nacked_sequence_numbers += nack_batch_.size();
+      nack_sender_(media_ssrc, nack_batch_);
+    }
+    if (given_up) {
+      keyframe_requester_(media_ssrc);
+    }
+    missing |= stream.missing_count > 0;
+  }
+  if (missing) {
+    ScheduleProcess();
+  }
+}
+
+}  // namespace libp2p_peerconnection
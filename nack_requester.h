@@ -0,0 +1,147 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_NACK_REQUESTER_H_
+#define _C_PC_NACK_REQUESTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <bitset>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "rtc_base/task_utils/pending_task_safety_flag.h"
+#include "rtc_base/thread.h"
+
+namespace libp2p_peerconnection {
+
+// Receive side of generic NACK (RFC 4585).
+//
+// Sequence number gaps are tracked per media SSRC in a bitmap covering the
+// last kMaxPacketAge sequence numbers, with a retry count and the time of
+// the last request next to each bit. All of it is sized when the stream is
+// first seen, so a burst loss costs no allocations. Every kProcessIntervalMs
+// the missing packets whose last request is older than one RTT are asked
+// for again, in one NACK per SSRC.
+//
+// A packet is given up after kMaxRetries requests, or when it falls out of
+// the window. A gap that would take the list past kMaxMissingPackets drops
+// the whole list instead. Either way a keyframe is requested.
+//
+// Lives on the network thread. The timer only runs while packets are
+// missing.
+class NackRequester {
+ public:
+  // Matches VideoPacketBuffer::kDefaultCapacity; an older packet could not
+  // be used anyway.
+  static constexpr size_t kMaxPacketAge = 512;
+  static constexpr size_t kMaxMissingPackets = 256;
+  static constexpr int kMaxRetries = 10;
+  static constexpr int kProcessIntervalMs = 20;
+  // Until the first receiver report with an RTT.
+  static constexpr int64_t kDefaultRttMs = 100;
+  static constexpr size_t kMaxStreams = 4;
+
+  // Asked to send one NACK for `sequence_numbers` of `media_ssrc`, oldest
+  // first.
+  using NackSender =
+      std::function<void(uint32_t media_ssrc,
+                         const std::vector<uint16_t>& sequence_numbers)>;
+  // Asked for a keyframe after packets of `media_ssrc` were given up.
+  using KeyFrameRequester = std::function<void(uint32_t media_ssrc)>;
+
+  struct Stats {
+    int64_t nack_packets = 0;
+    int64_t nacked_sequence_numbers = 0;
+    // Missing packets that arrived after a NACK.
+    int64_t recovered_packets = 0;
+    // Missing packets that arrived before the first NACK.
+    int64_t reordered_packets = 0;
+    // Missing packets given up.
+    int64_t lost_packets = 0;
+  };
+
+  NackRequester(rtc::Thread* network_thread,
+                NackSender nack_sender,
+                KeyFrameRequester keyframe_requester);
+  ~NackRequester();
+
+  NackRequester(const NackRequester&) = delete;
+  NackRequester& operator=(const NackRequester&) = delete;
+
+  // Media packets, including recovered retransmissions.
+  void OnReceivedPacket(uint32_t media_ssrc,
+                        uint16_t sequence_number,
+                        int64_t now_ms);
+  // Stops asking for packets of `media_ssrc` before `sequence_number`, e.g.
+  // after a keyframe made them useless.
+  void ClearUpTo(uint32_t media_ssrc, uint16_t sequence_number);
+  void UpdateRtt(int64_t rtt_ms);
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  static constexpr size_t kIndexMask = kMaxPacketAge - 1;
+  static_assert((kMaxPacketAge & kIndexMask) == 0,
+                "kMaxPacketAge must be a power of two");
+  static_assert(kMaxMissingPackets < kMaxPacketAge,
+                "a gap must fit in the window");
+
+  struct Stream {
+    // Unwrapped sequence number of the newest packet, -1 before the first
+    // one.
+    int64_t newest_sequence_number = -1;
+    int64_t last_receive_time_ms = 0;
+    size_t missing_count = 0;
+    // Indexed by the low bits of the sequence number.
+    std::bitset<kMaxPacketAge> missing;
+    std::array<uint8_t, kMaxPacketAge> retries;
+    // -1 until the first request.
+    std::array<int64_t, kMaxPacketAge> request_time_ms;
+  };
+
+  Stream* GetStream(uint32_t media_ssrc, int64_t now_ms);
+  // Unwraps `sequence_number` relative to the stream's newest packet.
+  static int64_t Unwrap(const Stream& stream, uint16_t sequence_number);
+  // Oldest unwrapped sequence number still in the window.
+  static int64_t OldestTracked(const Stream& stream);
+  void Clear(Stream* stream);
+  void ScheduleProcess();
+  void Process(int64_t now_ms);
+
+  rtc::Thread* const network_thread_;
+  const NackSender nack_sender_;
+  const KeyFrameRequester keyframe_requester_;
+
+  std::map<uint32_t, Stream> streams_;
+  int64_t rtt_ms_ = kDefaultRttMs;
+  // Reused by every NACK.
+  std::vector<uint16_t> nack_batch_;
+  bool process_scheduled_ = false;
+  Stats stats_;
+
+  webrtc::ScopedTaskSafety task_safety_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_NACK_REQUESTER_H_
@@ -0,0 +1,93 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/packet_buffer_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace libp2p_peerconnection {
+
+PacketBufferPool* PacketBufferPool::Current() {
+  thread_local PacketBufferPool pool;
+  return &pool;
+}
+
+PacketBufferPool::PacketBufferPool() {
+  for (std::vector<rtc::CopyOnWriteBuffer>& free_buffers : free_buffers_) {
+    free_buffers.reserve(kMaxPooledBuffers);
+  }
+}
+
+PacketBufferPool::~PacketBufferPool() = default;
+
+rtc::CopyOnWriteBuffer PacketBufferPool::Acquire(const uint8_t* data,
+                                                 size_t size,
+                                                 size_t min_capacity) {
+  const size_t needed = std::max(size + kTrailerHeadroom, min_capacity);
+  if (needed > kLargeBufferCapacity) {
+    ++stats_.misses;
+    return rtc::CopyOnWriteBuffer(data, size, needed);
+  }
+  const SizeClass size_class =
+      needed <= kSmallBufferCapacity ? kSmall : kLarge;
+  std::vector<rtc::CopyOnWriteBuffer>& free_buffers = free_buffers_[size_class];
+  if (free_buffers.empty()) {
+    ++stats_.misses;
+    return rtc::CopyOnWriteBuffer(data, size,
+                                  size_class == kSmall ? kSmallBufferCapacity
+                                                       : kLargeBufferCapacity);
+  }
+
+  rtc::CopyOnWriteBuffer buffer = std::move(free_buffers.back());
+  free_buffers.pop_back();
+  --stats_.pooled;
+  // SetData() writes in place unless the storage is still referenced
+  // elsewhere, in which case it allocates a new one.
+  const uint8_t* storage = buffer.cdata();
+  buffer.SetData(data, size);
+  if (buffer.cdata() == storage) {
+    ++stats_.hits;
+  } else {
+    ++stats_.misses;
+  }
+  return buffer;
+}
+
+void PacketBufferPool::Release(rtc::CopyOnWriteBuffer buffer) {
+  const size_t capacity = buffer.capacity();
+  SizeClass size_class;
+  if (capacity >= kLargeBufferCapacity && capacity < 2 * kLargeBufferCapacity) {
+    size_class = kLarge;
+  } else if (capacity >= kSmallBufferCapacity &&
+             capacity < kLargeBufferCapacity) {
+    size_class = kSmall;
+  } else {
+    return;
+  }
+  std::vector<rtc::CopyOnWriteBuffer>& free_buffers = free_buffers_[size_class];
+  if (free_buffers.size() >= kMaxPooledBuffers) {
+    return;
+  }
+  free_buffers.push_back(std::move(buffer));
+  ++stats_.pooled;
+  stats_.high_water_mark = std::max(stats_.high_water_mark, stats_.pooled);
+}
+
+}  // namespace libp2p_peerconnection
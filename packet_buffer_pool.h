@@ -0,0 +1,107 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_PACKET_BUFFER_POOL_H_
+#define _C_PC_PACKET_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "rtc_base/copy_on_write_buffer.h"
+
+namespace libp2p_peerconnection {
+
+// Per-thread, size-classed pool of packet buffers for the transport hot paths.
+//
+// Buffers are plain rtc::CopyOnWriteBuffer objects that are kept alive after
+// use instead of being freed. Because the buffer is copy-on-write, handing a
+// buffer back while somebody else still references it is safe: the next
+// Acquire() notices that the storage is shared, gets a fresh allocation and
+// counts a miss.
+//
+// The network thread is where both ends meet: sent packets are released there
+// after the socket copied them, and received datagrams are acquired there.
+class PacketBufferPool {
+ public:
+  // RTCP and audio.
+  static constexpr size_t kSmallBufferCapacity = 256;
+  // One MTU sized packet plus headroom for the SRTP trailer.
+  static constexpr size_t kLargeBufferCapacity = 2048;
+  // Spare bytes kept after the data so an outgoing packet can be SRTP
+  // protected in place (auth tag + MKI).
+  static constexpr size_t kTrailerHeadroom = 32;
+  // Per size class; a burst beyond this is handed back to the allocator.
+  static constexpr size_t kMaxPooledBuffers = 512;
+
+  struct Stats {
+    int64_t hits = 0;
+    // Acquires that had to allocate, including reused buffers that turned out
+    // to be still shared.
+    int64_t misses = 0;
+    // Buffers currently kept by the pool, and the most it ever kept.
+    size_t pooled = 0;
+    size_t high_water_mark = 0;
+
+    double miss_rate() const {
+      const int64_t total = hits + misses;
+      return total == 0 ? 0.0 : static_cast<double>(misses) / total;
+    }
+  };
+
+  // Returns the pool of the calling thread.
+  static PacketBufferPool* Current();
+
+  PacketBufferPool();
+  ~PacketBufferPool();
+
+  PacketBufferPool(const PacketBufferPool&) = delete;
+  PacketBufferPool& operator=(const PacketBufferPool&) = delete;
+
+  // Returns a uniquely owned buffer holding a copy of `data` with at least
+  // kTrailerHeadroom bytes of spare capacity.
+  rtc::CopyOnWriteBuffer Acquire(const uint8_t* data, size_t size) {
+    return Acquire(data, size, 0);
+  }
+  // Same, with a capacity of at least `min_capacity`, e.g. an RTP header that
+  // the payload is written behind later.
+  rtc::CopyOnWriteBuffer Acquire(const uint8_t* data,
+                                 size_t size,
+                                 size_t min_capacity);
+  rtc::CopyOnWriteBuffer Acquire(const char* data, size_t size) {
+    return Acquire(reinterpret_cast<const uint8_t*>(data), size);
+  }
+
+  // Gives `buffer` back to the pool. Buffers whose capacity doesn't fit a size
+  // class, or that exceed the pool limit, are simply freed.
+  void Release(rtc::CopyOnWriteBuffer buffer);
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  enum SizeClass { kSmall = 0, kLarge = 1, kNumSizeClasses = 2 };
+
+  std::vector<rtc::CopyOnWriteBuffer> free_buffers_[kNumSizeClasses];
+  Stats stats_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_PACKET_BUFFER_POOL_H_
@@ -0,0 +1,135 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/rtp_packet_history.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+constexpr int kBitrateWindowMs = 1000;
+constexpr float kBitsPerByte = 8000.0f;
+
+size_t HistoryCapacity(int history_ms) {
+  const size_t wanted = static_cast<size_t>(std::max(history_ms, 0)) *
+                        RtpPacketHistory::kMaxPacketsPerSecond / 1000;
+  size_t capacity = RtpPacketHistory::kMinCapacity;
+  while (capacity < wanted && capacity < RtpPacketHistory::kMaxCapacity) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+}  // namespace
+
+RtpPacketHistory::RtpPacketHistory(int history_ms)
+    : history_ms_(history_ms),
+      mask_(HistoryCapacity(history_ms) - 1),
+      packets_(mask_ + 1),
+      retransmit_rate_(kBitrateWindowMs, kBitsPerByte) {}
+
+RtpPacketHistory::~RtpPacketHistory() = default;
+
+void RtpPacketHistory::PutRtpPacket(
+    std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> packet,
+    int64_t send_time_ms) {
+  const uint16_t sequence_number = packet->SequenceNumber();
+  webrtc::MutexLock lock(&lock_);
+  StoredPacket& slot = packets_[sequence_number & mask_];
+  slot.packet = std::move(packet);
+  slot.send_time_ms = send_time_ms;
+  slot.retransmit_time_ms = -1;
+  has_packets_ = true;
+  newest_sequence_number_ = sequence_number;
+}
+
+std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>
+RtpPacketHistory::GetPacketAndMarkAsRetransmitted(uint16_t sequence_number,
+                                                  int64_t now_ms) {
+  webrtc::MutexLock lock(&lock_);
+  StoredPacket& slot = packets_[sequence_number & mask_];
+  if (!slot.packet || slot.packet->SequenceNumber() != sequence_number ||
+      now_ms - slot.send_time_ms > history_ms_) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  ++stats_.hits;
+  // The receiver keeps NACKing until the retransmission arrives; one
+  // retransmission per round trip is enough.
+  if (slot.retransmit_time_ms >= 0 &&
+      now_ms - slot.retransmit_time_ms < rtt_ms_) {
+    return nullptr;
+  }
+  slot.retransmit_time_ms = now_ms;
+  // Shares the payload buffer with the stored packet.
+  return std::make_unique<libmedia_transfer_protocol::RtpPacketToSend>(
+      *slot.packet);
+}
+
+size_t RtpPacketHistory::VisitPacketsForPadding(
+    size_t target_size,
+    int64_t now_ms,
+    rtc::FunctionView<void(const libmedia_transfer_protocol::RtpPacketToSend&)>
+        visitor) {
+  webrtc::MutexLock lock(&lock_);
+  if (!has_packets_) {
+    return 0;
+  }
+  size_t total_size = 0;
+  size_t num_packets = 0;
+  uint16_t sequence_number = newest_sequence_number_;
+  while (total_size < target_size && num_packets < kMaxPaddingPackets) {
+    const StoredPacket& slot = packets_[sequence_number & mask_];
+    if (!slot.packet || slot.packet->SequenceNumber() != sequence_number ||
+        now_ms - slot.send_time_ms > history_ms_) {
+      break;
+    }
+    total_size += slot.packet->size();
+    visitor(*slot.packet);
+    ++num_packets;
+    --sequence_number;
+  }
+  return num_packets;
+}
+
+void RtpPacketHistory::OnRetransmissionSent(size_t packet_size,
+                                            int64_t now_ms) {
+  webrtc::MutexLock lock(&lock_);
+  ++stats_.retransmitted_packets;
+  stats_.retransmitted_bytes += packet_size;
+  retransmit_rate_.Update(packet_size, now_ms);
+}
+
+void RtpPacketHistory::SetRtt(int64_t rtt_ms) {
+  webrtc::MutexLock lock(&lock_);
+  rtt_ms_ = std::max<int64_t>(rtt_ms, 0);
+}
+
+RtpPacketHistory::Stats RtpPacketHistory::GetStats(int64_t now_ms) {
+  webrtc::MutexLock lock(&lock_);
+  Stats stats = stats_;
+  stats.retransmit_bitrate_bps =
+      static_cast<uint32_t>(retransmit_rate_.Rate(now_ms).value_or(0));
+  return stats;
+}
+
+}  // namespace libp2p_peerconnection
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_RTP_PACKET_HISTORY_H_
+#define _C_PC_RTP_PACKET_HISTORY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "libmedia_transfer_protocol/rtp_rtcp/rtp_packet_to_send.h"
+#include "rtc_base/function_view.h"
+#include "rtc_base/rate_statistics.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace libp2p_peerconnection {
+
+// Sent media packets kept for answering NACKs. Storage is a ring of
+// power-of-two size indexed directly by the low bits of the RTP sequence
+// number, so storing and looking up a packet never allocates or searches.
+// The ring is sized for `history_ms` of video at kMaxPacketsPerSecond; older
+// packets are overwritten as the sequence number wraps around the ring.
+//
+// Packets are put by the pacer thread and looked up by the network thread.
+class RtpPacketHistory {
+ public:
+  static constexpr int kMaxPacketsPerSecond = 1000;
+  static constexpr size_t kMinCapacity = 64;
+  // Must stay below half the sequence number space.
+  static constexpr size_t kMaxCapacity = 1 << 14;
+  static constexpr size_t kMaxPaddingPackets = 16;
+
+  struct Stats {
+    // NACKed sequence numbers found in, and missing from, the history.
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t retransmitted_packets = 0;
+    int64_t retransmitted_bytes = 0;
+    uint32_t retransmit_bitrate_bps = 0;
+  };
+
+  explicit RtpPacketHistory(int history_ms);
+  ~RtpPacketHistory();
+
+  RtpPacketHistory(const RtpPacketHistory&) = delete;
+  RtpPacketHistory& operator=(const RtpPacketHistory&) = delete;
+
+  void PutRtpPacket(
+      std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> packet,
+      int64_t send_time_ms);
+
+  // Returns a copy of the packet with `sequence_number`, or nullptr if it
+  // was overwritten, is older than the history window, or was already
+  // retransmitted less than one RTT ago.
+  std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend>
+  GetPacketAndMarkAsRetransmitted(uint16_t sequence_number, int64_t now_ms);
+
+  // Calls `visitor` with the most recently sent packets, newest first, until
+  // their sizes add up to `target_size` or kMaxPaddingPackets were visited,
+  // and returns how many were. Used to build bandwidth probes from media
+  // instead of empty padding; does not count as a retransmission. The
+  // visitor runs under the history lock and must not call back into it; it
+  // reads the stored packet in place, so nothing is copied for it.
+  size_t VisitPacketsForPadding(
+      size_t target_size,
+      int64_t now_ms,
+      rtc::FunctionView<void(const libmedia_transfer_protocol::RtpPacketToSend&)>
+          visitor);
+
+  // Called when an RTX packet actually left the pacer.
+  void OnRetransmissionSent(size_t packet_size, int64_t now_ms);
+
+  void SetRtt(int64_t rtt_ms);
+
+  Stats GetStats(int64_t now_ms);
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct StoredPacket {
+    std::unique_ptr<libmedia_transfer_protocol::RtpPacketToSend> packet;
+    int64_t send_time_ms = 0;
+    // -1 until the packet is retransmitted.
+    int64_t retransmit_time_ms = -1;
+  };
+
+  const int64_t history_ms_;
+  const size_t mask_;
+
+  webrtc::Mutex lock_;
+  std::vector<StoredPacket> packets_ RTC_GUARDED_BY(lock_);
+  bool has_packets_ RTC_GUARDED_BY(lock_) = false;
+  uint16_t newest_sequence_number_ RTC_GUARDED_BY(lock_) = 0;
+  int64_t rtt_ms_ RTC_GUARDED_BY(lock_) = 0;
+  Stats stats_ RTC_GUARDED_BY(lock_);
+  webrtc::RateStatistics retransmit_rate_ RTC_GUARDED_BY(lock_);
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_RTP_PACKET_HISTORY_H_
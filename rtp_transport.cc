@@ -26,15 +26,22 @@
 #include "absl/strings/string_view.h"
 #include "api/array_view.h"
 #include "libmedia_transfer_protocol/rtp_utils.h"
+#include "libp2p_peerconnection/packet_buffer_pool.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
 
 namespace libp2p_peerconnection {
 
+RtpTransport::~RtpTransport() {
+  SocketReadBatch::RemoveReceiver(this);
+}
+
 void RtpTransport::SetRtcpMuxEnabled(bool enable) {
   rtcp_mux_enabled_ = enable;
   MaybeSignalReadyToSend();
@@ -146,6 +153,19 @@ bool RtpTransport::SendRtcpPacket(rtc::CopyOnWriteBuffer* packet,
   return SendPacket(true, packet, options, flags);
 }
 
+size_t RtpTransport::SendRtpPackets(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer* const> packets,
+    const rtc::PacketOptions& options,
+    int flags) {
+  size_t num_sent = 0;
+  for (rtc::CopyOnWriteBuffer* packet : packets) {
+    if (SendRtpPacket(packet, options, flags)) {
+      ++num_sent;
+    }
+  }
+  return num_sent;
+}
+
 bool RtpTransport::SendPacket(bool rtcp,
                               rtc::CopyOnWriteBuffer* packet,
                               const rtc::PacketOptions& options,
@@ -167,7 +187,11 @@ bool RtpTransport::SendPacket(bool rtcp,
 
 void RtpTransport::UpdateRtpHeaderExtensionMap(
     const libp2p_peerconnection::RtpHeaderExtensions& header_extensions) {
-  header_extension_map_ = libmedia_transfer_protocol::RtpHeaderExtensionMap(header_extensions);
+  header_extension_map_ = webrtc::RtpHeaderExtensionMap();
+  for (const libmedia_transfer_protocol::RtpExtension& extension :
+       header_extensions) {
+    header_extension_map_.RegisterByUri(extension.id, extension.uri);
+  }
 }
 
 bool RtpTransport::RegisterRtpDemuxerSink(const webrtc::RtpDemuxerCriteria& criteria,
@@ -190,24 +214,35 @@ bool RtpTransport::UnregisterRtpDemuxerSink(webrtc::RtpPacketSinkInterface* sink
 
 void RtpTransport::DemuxPacket(rtc::CopyOnWriteBuffer packet,
                                int64_t packet_time_us) {
+  // The packet takes over the buffer, the payload is not copied.
+  webrtc::RtpPacketReceived parsed_packet(
+      &header_extension_map_, packet_time_us == -1
+                                  ? webrtc::Timestamp::MinusInfinity()
+                                  : webrtc::Timestamp::Micros(packet_time_us));
+  if (!parsed_packet.Parse(std::move(packet))) {
+    RTC_LOG(LS_ERROR)
+        << "Failed to parse the incoming RTP packet before demuxing. Drop it.";
+    return;
+  }
 
-	// TODO@chensong  2025-09-24   ʱpacket demux ߼
-	RTC_LOG_F(LS_WARNING) << "not demux  TODO @chensong ";
-  //webrtc::RtpPacketReceived parsed_packet(
-  //    &header_extension_map_, packet_time_us == -1
-  //                                ? webrtc::Timestamp::MinusInfinity()
-  //                                : webrtc::Timestamp::Micros(packet_time_us));
-  //if (!parsed_packet.Parse(std::move(packet))) {
-  //  RTC_LOG(LS_ERROR)
-  //      << "Failed to parse the incoming RTP packet before demuxing. Drop it.";
-  //  return;
-  //}
-  //
-  //if (!rtp_demuxer_.OnRtpPacket(parsed_packet)) {
-  //  RTC_LOG(LS_WARNING) << "Failed to demux RTP packet: "
-  //                      << webrtc::RtpDemuxer::DescribePacket(parsed_packet);
-  //}
-} //
+  uint16_t transport_sequence_number;
+  if (parsed_packet.GetExtension<webrtc::TransportSequenceNumber>(
+          &transport_sequence_number)) {
+    SignalTransportSequenceNumberReceived(
+        parsed_packet.Ssrc(), transport_sequence_number,
+        packet_time_us == -1 ? rtc::TimeMicros() : packet_time_us);
+  }
+
+  if (!rtp_demuxer_.OnRtpPacket(parsed_packet)) {
+    RTC_LOG(LS_WARNING) << "Failed to demux RTP packet: "
+                        << webrtc::RtpDemuxer::DescribePacket(parsed_packet);
+  }
+  if (kTransportPerfLatencyEnabled && packet_time_us != -1) {
+    receive_perf_counters_.latency_us.Add(rtc::TimeMicros() - packet_time_us);
+  }
+  // Sinks that keep the packet share the storage; the pool copes with that.
+  PacketBufferPool::Current()->Release(parsed_packet.Buffer());
+}
 
 bool RtpTransport::IsTransportWritable() {
   auto rtcp_packet_transport =
@@ -241,12 +276,38 @@ void RtpTransport::OnSentPacket(libice::PacketTransportInternal* packet_transpor
 
 void RtpTransport::OnRtpPacketReceived(rtc::CopyOnWriteBuffer packet,
                                        int64_t packet_time_us) {
-  DemuxPacket(packet, packet_time_us);
+  DemuxPacket(std::move(packet), packet_time_us);
 }
 
 void RtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer packet,
                                         int64_t packet_time_us) {
   SignalRtcpPacketReceived(&packet, packet_time_us);
+  PacketBufferPool::Current()->Release(std::move(packet));
+}
+
+void RtpTransport::OnRtpPacketsReceived(
+    std::vector<ReceivedRtpPacket>* packets) {
+  for (ReceivedRtpPacket& received : *packets) {
+    DemuxPacket(std::move(received.packet), received.packet_time_us);
+  }
+}
+
+void RtpTransport::SetInboundBatchingEnabled(bool enabled) {
+  if (!enabled) {
+    FlushReadBatch();
+  }
+  inbound_batching_enabled_ = enabled;
+}
+
+void RtpTransport::FlushReadBatch() {
+  if (inbound_rtp_batch_.empty()) {
+    return;
+  }
+  TRACE_EVENT1("webrtc", "RtpTransport::FlushReadBatch", "size",
+               inbound_rtp_batch_.size());
+  OnRtpPacketsReceived(&inbound_rtp_batch_);
+  // clear() keeps the capacity for the next burst.
+  inbound_rtp_batch_.clear();
 }
 
 void RtpTransport::OnReadPacket(libice::PacketTransportInternal* transport,
@@ -273,11 +334,29 @@ void RtpTransport::OnReadPacket(libice::PacketTransportInternal* transport,
     return;
   }
 
-  rtc::CopyOnWriteBuffer packet(data, len);
+  rtc::CopyOnWriteBuffer packet = PacketBufferPool::Current()->Acquire(data, len);
   if (packet_type == libmedia_transfer_protocol::RtpPacketType::kRtcp) {
+    // Keep the arrival order: the RTP read before it goes first.
+    FlushReadBatch();
     OnRtcpPacketReceived(std::move(packet), packet_time_us);
-  } else {
+    return;
+  }
+
+  ++receive_perf_counters_.packets;
+  receive_perf_counters_.bytes += len;
+  if (!inbound_batching_enabled_) {
+    OnRtpPacketReceived(std::move(packet), packet_time_us);
+    return;
+  }
+  // Outside a socket read event, e.g. a socket that reads one datagram per
+  // event, there is no burst to wait for.
+  if (inbound_rtp_batch_.empty() && !SocketReadBatch::AddReceiver(this)) {
     OnRtpPacketReceived(std::move(packet), packet_time_us);
+    return;
+  }
+  inbound_rtp_batch_.push_back({std::move(packet), packet_time_us});
+  if (inbound_rtp_batch_.size() >= kMaxInboundRtpBatchSize) {
+    FlushReadBatch();
   }
 }
 
@@ -24,13 +24,17 @@
 #include <stdint.h>
 
 #include <string>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "call/rtp_demuxer.h"
-#include "libmedia_transfer_protocol/rtp_rtcp/rtp_header_extension_map.h"
+#include "libp2p_peerconnection/flat_rtp_demuxer.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "libice/packet_transport_internal.h"
 #include "libp2p_peerconnection/rtp_transport_internal.h"
 #include "libp2p_peerconnection/csession_description.h"
+#include "libp2p_peerconnection/socket_read_batch.h"
+#include "libp2p_peerconnection/transport_perf_stats.h"
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/network/sent_packet.h"
@@ -46,13 +50,15 @@
 
 namespace libp2p_peerconnection {
 	//class PacketTransportInternal;
-class RtpTransport : public RtpTransportInternal {
+class RtpTransport : public RtpTransportInternal,
+                     public SocketReadBatch::Receiver {
  public:
   RtpTransport(const RtpTransport&) = delete;
   RtpTransport& operator=(const RtpTransport&) = delete;
 
   explicit RtpTransport(bool rtcp_mux_enabled)
       : rtcp_mux_enabled_(rtcp_mux_enabled) {}
+  ~RtpTransport() override;
 
   bool rtcp_mux_enabled() const override { return rtcp_mux_enabled_; }
   void SetRtcpMuxEnabled(bool enable) override;
@@ -84,6 +90,10 @@ class RtpTransport : public RtpTransportInternal {
                       const rtc::PacketOptions& options,
                       int flags) override;
 
+  size_t SendRtpPackets(rtc::ArrayView<rtc::CopyOnWriteBuffer* const> packets,
+                        const rtc::PacketOptions& options,
+                        int flags) override;
+
   bool IsSrtpActive() const override { return false; }
 
   void UpdateRtpHeaderExtensionMap(
@@ -94,7 +104,25 @@ class RtpTransport : public RtpTransportInternal {
 
   bool UnregisterRtpDemuxerSink(webrtc::RtpPacketSinkInterface* sink) override;
 
+  // In batch mode the RTP packets read during one socket read event (see
+  // SocketReadBatch) are collected and handed to OnRtpPacketsReceived()
+  // together when the event ends, so that unprotect and demux each run as a
+  // tight loop over the burst instead of once per datagram. An RTCP packet
+  // first flushes the RTP packets read before it. Must be called on the
+  // network thread.
+  void SetInboundBatchingEnabled(bool enabled);
+
+  // Received RTP packets and their read-to-demux latency.
+  const TransportPerfCounters& receive_perf_counters() const {
+    return receive_perf_counters_;
+  }
+
  protected:
+  struct ReceivedRtpPacket {
+    rtc::CopyOnWriteBuffer packet;
+    int64_t packet_time_us;
+  };
+
   // These methods will be used in the subclasses.
   void DemuxPacket(rtc::CopyOnWriteBuffer packet, int64_t packet_time_us);
 
@@ -110,6 +138,9 @@ class RtpTransport : public RtpTransportInternal {
                                    int64_t packet_time_us);
   virtual void OnRtcpPacketReceived(rtc::CopyOnWriteBuffer packet,
                                     int64_t packet_time_us);
+  // Batch mode counterpart of OnRtpPacketReceived(). The packets may be
+  // consumed (moved from); the vector is cleared by the caller.
+  virtual void OnRtpPacketsReceived(std::vector<ReceivedRtpPacket>* packets);
   // Overridden by SrtpTransport and DtlsSrtpTransport.
   virtual void OnWritableState(libice::PacketTransportInternal* packet_transport);
 
@@ -122,6 +153,8 @@ class RtpTransport : public RtpTransportInternal {
                     size_t len,
                     const int64_t& packet_time_us,
                     int flags);
+  // SocketReadBatch::Receiver.
+  void FlushReadBatch() override;
 
   // Updates "ready to send" for an individual channel and fires
   // SignalReadyToSend.
@@ -140,10 +173,18 @@ class RtpTransport : public RtpTransportInternal {
   bool rtp_ready_to_send_ = false;
   bool rtcp_ready_to_send_ = false;
 
-  webrtc::RtpDemuxer rtp_demuxer_;
+  FlatRtpDemuxer rtp_demuxer_;
+
+  // Used for identifying the MID for RtpDemuxer. Same map type as the
+  // webrtc::RtpPacketReceived handed to the sinks.
+  webrtc::RtpHeaderExtensionMap header_extension_map_;
+
+  // Upper bound on a batch, so a long burst can't delay the first packet.
+  static constexpr size_t kMaxInboundRtpBatchSize = 64;
+  bool inbound_batching_enabled_ = false;
+  std::vector<ReceivedRtpPacket> inbound_rtp_batch_;
 
-  // Used for identifying the MID for RtpDemuxer.
-  libmedia_transfer_protocol::RtpHeaderExtensionMap header_extension_map_;
+  TransportPerfCounters receive_perf_counters_;
 };
 
 }  // namespace webrtc
@@ -20,8 +20,11 @@
 #ifndef  _C_PC_RTP_TRANSPORT_INTERNAL_H_
 #define _C_PC_RTP_TRANSPORT_INTERNAL_H_
 
+#include <stddef.h>
+
 #include <string>
 
+#include "api/array_view.h"
 #include "call/rtp_demuxer.h"
 #include "libice/ice_transport_internal.h"
 #include "libp2p_peerconnection/csession_description.h"
@@ -66,6 +69,12 @@ class RtpTransportInternal : public sigslot::has_slots<> {
   // the RtpDemuxer callback.
   sigslot::signal2<rtc::CopyOnWriteBuffer*, int64_t> SignalRtcpPacketReceived;
 
+  // Called for every received RTP packet that carries a transport-wide
+  // sequence number, with the packet's SSRC, that sequence number and its
+  // arrival time in microseconds. Feeds the transport-cc feedback.
+  sigslot::signal3<uint32_t, uint16_t, int64_t>
+      SignalTransportSequenceNumberReceived;
+
   // Called whenever the network route of the P2P layer transport changes.
   // The argument is an optional network route.
   sigslot::signal1<absl::optional<rtc::NetworkRoute>> SignalNetworkRouteChanged;
@@ -88,6 +97,13 @@ class RtpTransportInternal : public sigslot::has_slots<> {
                               const rtc::PacketOptions& options,
                               int flags) = 0;
 
+  // Sends a burst of RTP packets with the same options, in order. A packet
+  // that fails doesn't stop the rest. Returns the number of packets sent.
+  virtual size_t SendRtpPackets(
+      rtc::ArrayView<rtc::CopyOnWriteBuffer* const> packets,
+      const rtc::PacketOptions& options,
+      int flags) = 0;
+
   // This method updates the RTP header extension map so that the RTP transport
   // can parse the received packets and identify the MID. This is called by the
   // BaseChannel when setting the content description.
@@ -0,0 +1,296 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/rtp_video_stream_receiver.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/byte_io.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/location.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+#include "rtc_base/time_utils.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+// RFC 4588: the RTX payload starts with the original sequence number.
+constexpr size_t kRtxHeaderSize = 2;
+
+static_assert(NackRequester::kMaxPacketAge <=
+                  VideoPacketBuffer::kDefaultCapacity,
+              "NACKing packets the buffer has already dropped");
+
+}  // namespace
+
+RtpVideoStreamReceiver::RtpVideoStreamReceiver(
+    rtc::Thread* network_thread,
+    rtc::Thread* worker_thread,
+    uint8_t payload_type,
+    uint8_t rtx_payload_type,
+    KeyFrameRequestSender keyframe_request_sender,
+    NackRequester::NackSender nack_sender)
+    : network_thread_(network_thread),
+      worker_thread_(worker_thread),
+      payload_type_(payload_type),
+      rtx_payload_type_(rtx_payload_type),
+      keyframe_request_sender_(std::move(keyframe_request_sender)),
+      sink_state_(std::make_shared<SinkState>(worker_thread)),
+      nack_requester_(network_thread,
+                      std::move(nack_sender),
+                      [this](uint32_t /*media_ssrc*/) {
+                        RequestKeyFrame(rtc::TimeMillis());
+                      }) {
+  RTC_DCHECK(network_thread_);
+  RTC_DCHECK(worker_thread_);
+}
+
+RtpVideoStreamReceiver::~RtpVideoStreamReceiver() {
+  SetSink(nullptr);
+}
+
+void RtpVideoStreamReceiver::SetSink(EncodedVideoFrameSinkInterface* sink) {
+  if (sink_state_->worker_thread->IsCurrent()) {
+    // Deliveries run on this thread, so none is in flight, or the sink is
+    // calling back from one and sees the new sink from its next frame.
+    webrtc::MutexLock lock(&sink_state_->lock);
+    sink_state_->sink = sink;
+    return;
+  }
+  // Waits out a delivery in flight, so that the old sink is not called
+  // once this returns.
+  webrtc::MutexLock delivery_lock(&sink_state_->delivery_lock);
+  webrtc::MutexLock lock(&sink_state_->lock);
+  sink_state_->sink = sink;
+}
+
+bool RtpVideoStreamReceiver::SetBaseMinimumPlayoutDelayMs(int delay_ms) {
+  webrtc::MutexLock lock(&sink_state_->lock);
+  return sink_state_->jitter_buffer.SetBaseMinimumDelayMs(delay_ms);
+}
+
+int RtpVideoStreamReceiver::GetBaseMinimumPlayoutDelayMs() const {
+  webrtc::MutexLock lock(&sink_state_->lock);
+  return sink_state_->jitter_buffer.base_minimum_delay_ms();
+}
+
+void RtpVideoStreamReceiver::SetLowLatencyMode(bool enabled) {
+  webrtc::MutexLock lock(&sink_state_->lock);
+  sink_state_->jitter_buffer.SetLowLatencyMode(enabled);
+  if (enabled) {
+    // Whatever is held goes out now, not at its playout time.
+    sink_state_->worker_thread->PostTask(
+        RTC_FROM_HERE,
+        [sink_state = sink_state_]() { ReleaseFrames(sink_state); });
+  }
+}
+
+void RtpVideoStreamReceiver::OnRtpPacket(
+    const webrtc::RtpPacketReceived& packet) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  const int64_t now_ms = rtc::TimeMillis();
+  if (packet.PayloadType() == payload_type_) {
+    ++stats_.packets;
+    remote_ssrc_ = packet.Ssrc();
+    InsertPacket(packet, packet.SequenceNumber(), 0, now_ms);
+  } else if (rtx_payload_type_ != 0 &&
+             packet.PayloadType() == rtx_payload_type_) {
+    // RTX padding has no original packet; retransmissions before the first
+    // media packet have nothing to be matched to.
+    if (packet.payload_size() < kRtxHeaderSize || remote_ssrc_ == 0) {
+      return;
+    }
+    ++stats_.retransmitted_packets;
+    InsertPacket(packet,
+                 webrtc::ByteReader<uint16_t>::ReadBigEndian(
+                     packet.payload().data()),
+                 kRtxHeaderSize, now_ms);
+  }
+}
+
+void RtpVideoStreamReceiver::InsertPacket(
+    const webrtc::RtpPacketReceived& packet,
+    uint16_t sequence_number,
+    size_t payload_offset,
+    int64_t now_ms) {
+  nack_requester_.OnReceivedPacket(remote_ssrc_, sequence_number, now_ms);
+
+  const uint8_t* payload = packet.payload().data() + payload_offset;
+  const size_t payload_size = packet.payload_size() - payload_offset;
+  VideoPacketBuffer::InsertResult result;
+  if (payload_size == 0) {
+    result = packet_buffer_.InsertPadding(sequence_number);
+  } else {
+    VideoPacketBuffer::Packet video_packet;
+    if (!ParseH264Payload(payload, payload_size, &video_packet.info)) {
+      ++stats_.malformed_packets;
+      return;
+    }
+    video_packet.sequence_number = sequence_number;
+    video_packet.timestamp = packet.Timestamp();
+    video_packet.marker = packet.Marker();
+    video_packet.receive_time_ms = now_ms;
+    // No copy; the payload stays in the received buffer until the frame is
+    // complete.
+    video_packet.payload = packet.Buffer().Slice(
+        packet.headers_size() + payload_offset, payload_size);
+    result = packet_buffer_.InsertPacket(std::move(video_packet));
+  }
+
+  for (VideoPacketBuffer::Frame& frame : result.frames) {
+    DeliverFrame(std::move(frame));
+  }
+  if (result.buffer_cleared) {
+    // Nothing before this packet can be used any more.
+    nack_requester_.ClearUpTo(remote_ssrc_, sequence_number);
+  }
+  if (result.buffer_cleared || packet_buffer_.waiting_for_keyframe()) {
+    RequestKeyFrame(now_ms);
+  }
+}
+
+void RtpVideoStreamReceiver::RequestKeyFrame(int64_t now_ms) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (remote_ssrc_ == 0 ||
+      (last_keyframe_request_ms_ >= 0 &&
+       now_ms - last_keyframe_request_ms_ < kMinKeyFrameRequestIntervalMs)) {
+    return;
+  }
+  last_keyframe_request_ms_ = now_ms;
+  ++stats_.keyframe_requests;
+  keyframe_request_sender_(remote_ssrc_);
+}
+
+void RtpVideoStreamReceiver::UpdateRtt(int64_t rtt_ms) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  nack_requester_.UpdateRtt(rtt_ms);
+}
+
+RtpVideoStreamReceiver::Stats RtpVideoStreamReceiver::GetStats() const {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  Stats stats = stats_;
+  stats.frames = packet_buffer_.stats().frames;
+  stats.keyframes = packet_buffer_.stats().keyframes;
+  stats.nack = nack_requester_.stats();
+  webrtc::MutexLock lock(&sink_state_->lock);
+  stats.jitter_buffer = sink_state_->jitter_buffer.stats();
+  return stats;
+}
+
+void RtpVideoStreamReceiver::DeliverFrame(VideoPacketBuffer::Frame frame) {
+  // The only copy of the payload: from the received packets straight into
+  // the frame's buffer.
+  rtc::scoped_refptr<libmedia_codec::EncodedImageBuffer> buffer =
+      libmedia_codec::EncodedImageBuffer::Create(frame.annexb_size);
+  uint8_t* dst = buffer->data();
+  for (const VideoPacketBuffer::Frame::Payload& payload : frame.payloads) {
+    WriteH264AnnexB(payload.data.cdata(), payload.data.size(), dst);
+    dst += payload.annexb_size;
+  }
+
+  auto image = std::make_shared<libmedia_codec::EncodedImage>();
+  image->SetEncodedData(buffer);
+  image->SetTimestamp(frame.timestamp);
+  image->_frameType = frame.keyframe
+                          ? libmedia_codec::VideoFrameType::kVideoFrameKey
+                          : libmedia_codec::VideoFrameType::kVideoFrameDelta;
+  if (frame.keyframe) {
+    // The next keyframe request is only needed after a new loss, and the
+    // packets before the keyframe are no longer needed.
+    last_keyframe_request_ms_ = -1;
+    nack_requester_.ClearUpTo(remote_ssrc_, frame.first_sequence_number);
+  }
+
+  worker_thread_->PostTask(
+      RTC_FROM_HERE, [sink_state = sink_state_, image = std::move(image),
+                      receive_time_ms = frame.receive_time_ms]() mutable {
+        InsertFrame(sink_state, std::move(image), receive_time_ms);
+      });
+}
+
+void RtpVideoStreamReceiver::InsertFrame(
+    const std::shared_ptr<SinkState>& state,
+    std::shared_ptr<libmedia_codec::EncodedImage> image,
+    int64_t receive_time_ms) {
+  RTC_DCHECK_RUN_ON(state->worker_thread);
+  const int64_t now_ms = rtc::TimeMillis();
+  VideoJitterBuffer::Frames frames;
+  {
+    webrtc::MutexLock lock(&state->lock);
+    frames = state->jitter_buffer.InsertFrame(std::move(image),
+                                              receive_time_ms, now_ms);
+    ScheduleRelease(state, now_ms);
+  }
+  DeliverFrames(state, frames);
+}
+
+void RtpVideoStreamReceiver::ReleaseFrames(
+    const std::shared_ptr<SinkState>& state) {
+  RTC_DCHECK_RUN_ON(state->worker_thread);
+  const int64_t now_ms = rtc::TimeMillis();
+  VideoJitterBuffer::Frames frames;
+  {
+    webrtc::MutexLock lock(&state->lock);
+    state->scheduled_release_ms = -1;
+    frames = state->jitter_buffer.ReleaseFrames(now_ms);
+    ScheduleRelease(state, now_ms);
+  }
+  DeliverFrames(state, frames);
+}
+
+void RtpVideoStreamReceiver::DeliverFrames(
+    const std::shared_ptr<SinkState>& state,
+    const VideoJitterBuffer::Frames& frames) {
+  if (frames.empty()) {
+    return;
+  }
+  // `lock` is not held across the sink, which may call back into the
+  // receiver.
+  webrtc::MutexLock delivery_lock(&state->delivery_lock);
+  for (const std::shared_ptr<libmedia_codec::EncodedImage>& frame : frames) {
+    EncodedVideoFrameSinkInterface* sink;
+    {
+      webrtc::MutexLock lock(&state->lock);
+      sink = state->sink;
+    }
+    if (!sink) {
+      return;
+    }
+    sink->OnEncodedVideoFrame(frame);
+  }
+}
+
+void RtpVideoStreamReceiver::ScheduleRelease(
+    const std::shared_ptr<SinkState>& state,
+    int64_t now_ms) {
+  const int64_t next_release_ms = state->jitter_buffer.NextReleaseTimeMs();
+  if (next_release_ms < 0 || (state->scheduled_release_ms >= 0 &&
+                              state->scheduled_release_ms <= next_release_ms)) {
+    return;
+  }
+  state->scheduled_release_ms = next_release_ms;
+  state->worker_thread->PostDelayedTask(
+      webrtc::ToQueuedTask([state]() { ReleaseFrames(state); }),
+      static_cast<uint32_t>(std::max<int64_t>(next_release_ms - now_ms, 0)));
+}
+
+}  // namespace libp2p_peerconnection
@@ -0,0 +1,164 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_RTP_VIDEO_STREAM_RECEIVER_H_
+#define _C_PC_RTP_VIDEO_STREAM_RECEIVER_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+
+#include "call/rtp_packet_sink_interface.h"
+#include "libmedia_codec/encoded_image.h"
+#include "libp2p_peerconnection/nack_requester.h"
+#include "libp2p_peerconnection/video_jitter_buffer.h"
+#include "libp2p_peerconnection/video_packet_buffer.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace libp2p_peerconnection {
+
+// Receives the remote's video frames at their playout time, on the worker
+// thread.
+class EncodedVideoFrameSinkInterface {
+ public:
+  virtual ~EncodedVideoFrameSinkInterface() = default;
+
+  virtual void OnEncodedVideoFrame(
+      std::shared_ptr<libmedia_codec::EncodedImage> frame) = 0;
+};
+
+// Receive side of one H.264 video stream, registered as an RTP demuxer sink
+// for its payload type and its RTX payload type.
+//
+// Packets are depacketized and assembled on the network thread, where the
+// demuxer runs; only complete frames are posted to the worker thread, one
+// task per frame instead of one per packet, where a VideoJitterBuffer holds
+// them until their playout time. Lost packets are NACKed, and
+// RTX retransmissions are unwrapped back into the media stream. Keyframes
+// are requested while no decodable frame can be produced, at most every
+// kMinKeyFrameRequestIntervalMs.
+class RtpVideoStreamReceiver : public webrtc::RtpPacketSinkInterface {
+ public:
+  static constexpr int kMinKeyFrameRequestIntervalMs = 300;
+
+  // Asked to send a PLI for `media_ssrc`, on the network thread.
+  using KeyFrameRequestSender = std::function<void(uint32_t media_ssrc)>;
+
+  struct Stats {
+    int64_t packets = 0;
+    int64_t retransmitted_packets = 0;
+    int64_t malformed_packets = 0;
+    int64_t frames = 0;
+    int64_t keyframes = 0;
+    int64_t keyframe_requests = 0;
+    NackRequester::Stats nack;
+    VideoJitterBuffer::Stats jitter_buffer;
+  };
+
+  // `rtx_payload_type` is 0 when the remote does not send RTX.
+  RtpVideoStreamReceiver(rtc::Thread* network_thread,
+                         rtc::Thread* worker_thread,
+                         uint8_t payload_type,
+                         uint8_t rtx_payload_type,
+                         KeyFrameRequestSender keyframe_request_sender,
+                         NackRequester::NackSender nack_sender);
+  ~RtpVideoStreamReceiver() override;
+
+  RtpVideoStreamReceiver(const RtpVideoStreamReceiver&) = delete;
+  RtpVideoStreamReceiver& operator=(const RtpVideoStreamReceiver&) = delete;
+
+  uint8_t payload_type() const { return payload_type_; }
+  uint8_t rtx_payload_type() const { return rtx_payload_type_; }
+
+  // May be called on any thread; nullptr stops the delivery. Frames already
+  // posted to the worker thread are dropped.
+  void SetSink(EncodedVideoFrameSinkInterface* sink);
+
+  // Jitter buffer settings, may be called on any thread. See
+  // VideoJitterBuffer.
+  bool SetBaseMinimumPlayoutDelayMs(int delay_ms);
+  int GetBaseMinimumPlayoutDelayMs() const;
+  void SetLowLatencyMode(bool enabled);
+
+  // webrtc::RtpPacketSinkInterface, on the network thread.
+  void OnRtpPacket(const webrtc::RtpPacketReceived& packet) override;
+
+  // Network thread.
+  void RequestKeyFrame(int64_t now_ms);
+  void UpdateRtt(int64_t rtt_ms);
+  Stats GetStats() const;
+
+ private:
+  // Worker thread side, shared with the tasks posted there, which may
+  // outlive the receiver.
+  struct SinkState {
+    explicit SinkState(rtc::Thread* worker_thread)
+        : worker_thread(worker_thread) {}
+
+    rtc::Thread* const worker_thread;
+    // Held across the sink calls only, ahead of `lock`.
+    webrtc::Mutex delivery_lock;
+    webrtc::Mutex lock;
+    EncodedVideoFrameSinkInterface* sink RTC_GUARDED_BY(lock) = nullptr;
+    VideoJitterBuffer jitter_buffer RTC_GUARDED_BY(lock);
+    // Playout time the next release task is posted for, -1 when none.
+    int64_t scheduled_release_ms RTC_GUARDED_BY(lock) = -1;
+  };
+
+  // Worker thread.
+  static void InsertFrame(const std::shared_ptr<SinkState>& state,
+                          std::shared_ptr<libmedia_codec::EncodedImage> image,
+                          int64_t receive_time_ms);
+  static void ReleaseFrames(const std::shared_ptr<SinkState>& state);
+  // Calls the sink with `lock` released.
+  static void DeliverFrames(const std::shared_ptr<SinkState>& state,
+                            const VideoJitterBuffer::Frames& frames)
+      RTC_LOCKS_EXCLUDED(state->lock);
+  // Posts the release of the next frame held by the jitter buffer.
+  static void ScheduleRelease(const std::shared_ptr<SinkState>& state,
+                              int64_t now_ms)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(state->lock);
+
+  void InsertPacket(const webrtc::RtpPacketReceived& packet,
+                    uint16_t sequence_number,
+                    size_t payload_offset,
+                    int64_t now_ms);
+  void DeliverFrame(VideoPacketBuffer::Frame frame);
+
+  rtc::Thread* const network_thread_;
+  rtc::Thread* const worker_thread_;
+  const uint8_t payload_type_;
+  const uint8_t rtx_payload_type_;
+  const KeyFrameRequestSender keyframe_request_sender_;
+  const std::shared_ptr<SinkState> sink_state_;
+
+  VideoPacketBuffer packet_buffer_;
+  NackRequester nack_requester_;
+  uint32_t remote_ssrc_ = 0;
+  int64_t last_keyframe_request_ms_ = -1;
+  Stats stats_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_RTP_VIDEO_STREAM_RECEIVER_H_
@@ -0,0 +1,82 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/socket_read_batch.h"
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "rtc_base/checks.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+struct ReadBatchState {
+  int depth = 0;
+  // Removed receivers are nulled out, the flush may be iterating.
+  std::vector<SocketReadBatch::Receiver*> receivers;
+};
+
+ReadBatchState* CurrentState() {
+  thread_local ReadBatchState state;
+  return &state;
+}
+
+}  // namespace
+
+SocketReadBatch::SocketReadBatch() {
+  ++CurrentState()->depth;
+}
+
+SocketReadBatch::~SocketReadBatch() {
+  ReadBatchState* state = CurrentState();
+  RTC_DCHECK_GT(state->depth, 0);
+  if (--state->depth > 0) {
+    return;
+  }
+  // A flush may destroy another receiver, which then nulls out its entry.
+  for (size_t i = 0; i < state->receivers.size(); ++i) {
+    if (Receiver* receiver = state->receivers[i]) {
+      state->receivers[i] = nullptr;
+      receiver->FlushReadBatch();
+    }
+  }
+  state->receivers.clear();
+}
+
+bool SocketReadBatch::AddReceiver(Receiver* receiver) {
+  ReadBatchState* state = CurrentState();
+  if (state->depth == 0) {
+    return false;
+  }
+  state->receivers.push_back(receiver);
+  return true;
+}
+
+void SocketReadBatch::RemoveReceiver(Receiver* receiver) {
+  for (Receiver*& registered : CurrentState()->receivers) {
+    if (registered == receiver) {
+      registered = nullptr;
+    }
+  }
+}
+
+}  // namespace libp2p_peerconnection
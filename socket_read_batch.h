@@ -0,0 +1,58 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_SOCKET_READ_BATCH_H_
+#define _C_PC_SOCKET_READ_BATCH_H_
+
+namespace libp2p_peerconnection {
+
+// Marks the datagrams read during one socket read event on the calling
+// thread.
+//
+// BatchedAsyncUdpSocket opens one around the loop that drains its socket. A
+// receiver that queues the packets of a read event to process them together
+// registers itself with AddReceiver(). Its FlushReadBatch() runs when the
+// outermost batch on the thread closes, still inside the read event, so no
+// packet waits for a posted task.
+class SocketReadBatch {
+ public:
+  class Receiver {
+   public:
+    virtual void FlushReadBatch() = 0;
+
+   protected:
+    virtual ~Receiver() = default;
+  };
+
+  SocketReadBatch();
+  ~SocketReadBatch();
+
+  SocketReadBatch(const SocketReadBatch&) = delete;
+  SocketReadBatch& operator=(const SocketReadBatch&) = delete;
+
+  // Returns false without registering when no read event is in progress on
+  // this thread; the caller has to process its packet right away then.
+  static bool AddReceiver(Receiver* receiver);
+  // Called by a registered receiver that goes away before the flush.
+  static void RemoveReceiver(Receiver* receiver);
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_SOCKET_READ_BATCH_H_
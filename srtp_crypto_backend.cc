@@ -0,0 +1,384 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/srtp_crypto_backend.h"
+
+#include <string.h>
+
+#include <new>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "srtp.h"
+#include "crypto_kernel.h"
+
+// BoringSSL only; with OpenSSL the AEAD backend is compiled out and libsrtp's
+// own cipher stays in use.
+#if defined(__has_include)
+#if __has_include(<openssl/aead.h>)
+#include <openssl/aead.h>
+#endif
+#endif
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+SrtpCryptoBackend g_srtp_crypto_backend = SrtpCryptoBackend::kLibsrtp;
+
+#if defined(OPENSSL_IS_BORINGSSL)
+
+constexpr size_t kGcmIvLength = 12;
+constexpr int kMaxGcmTagLength = 16;
+
+// Per cipher state. libsrtp calls set_iv(), then set_aad() (possibly more than
+// once, SRTCP adds the index trailer separately), then encrypt()+get_tag() or
+// decrypt(). EVP_AEAD is one-shot, so the AAD is gathered until then.
+struct AeadCipherState {
+  const EVP_AEAD* aead = nullptr;
+  size_t key_size = 0;
+  size_t tag_len = 0;
+  bool ctx_initialized = false;
+  EVP_AEAD_CTX ctx;
+  uint8_t iv[kGcmIvLength] = {0};
+  srtp_cipher_direction_t direction = srtp_direction_any;
+  std::vector<uint8_t> aad;
+  uint8_t tag[kMaxGcmTagLength] = {0};
+};
+
+extern const srtp_cipher_type_t kAeadAes128GcmCipher;
+extern const srtp_cipher_type_t kAeadAes256GcmCipher;
+
+srtp_err_status_t AeadAlloc(srtp_cipher_t** cipher, int key_len, int tag_len) {
+  const srtp_cipher_type_t* type;
+  const EVP_AEAD* aead;
+  size_t key_size;
+  int algorithm;
+  if (key_len == SRTP_AES_GCM_128_KEY_LEN_WSALT) {
+    type = &kAeadAes128GcmCipher;
+    aead = EVP_aead_aes_128_gcm();
+    key_size = SRTP_AES_128_KEY_LEN;
+    algorithm = SRTP_AES_GCM_128;
+  } else if (key_len == SRTP_AES_GCM_256_KEY_LEN_WSALT) {
+    type = &kAeadAes256GcmCipher;
+    aead = EVP_aead_aes_256_gcm();
+    key_size = SRTP_AES_256_KEY_LEN;
+    algorithm = SRTP_AES_GCM_256;
+  } else {
+    return srtp_err_status_bad_param;
+  }
+  // Same tag lengths as libsrtp's GCM: full and 8 byte truncated.
+  if (tag_len != kMaxGcmTagLength && tag_len != 8) {
+    return srtp_err_status_bad_param;
+  }
+
+  srtp_cipher_t* new_cipher = new (std::nothrow) srtp_cipher_t();
+  AeadCipherState* state = new (std::nothrow) AeadCipherState();
+  if (!new_cipher || !state) {
+    delete new_cipher;
+    delete state;
+    return srtp_err_status_alloc_fail;
+  }
+  state->aead = aead;
+  state->key_size = key_size;
+  state->tag_len = static_cast<size_t>(tag_len);
+  EVP_AEAD_CTX_zero(&state->ctx);
+
+  new_cipher->type = type;
+  new_cipher->state = state;
+  new_cipher->key_len = key_len;
+  new_cipher->algorithm = algorithm;
+  *cipher = new_cipher;
+  return srtp_err_status_ok;
+}
+
+srtp_err_status_t AeadDealloc(srtp_cipher_t* cipher) {
+  AeadCipherState* state = static_cast<AeadCipherState*>(cipher->state);
+  if (state->ctx_initialized) {
+    EVP_AEAD_CTX_cleanup(&state->ctx);
+  }
+  delete state;
+  delete cipher;
+  return srtp_err_status_ok;
+}
+
+srtp_err_status_t AeadInit(void* cv, const uint8_t* key) {
+  AeadCipherState* state = static_cast<AeadCipherState*>(cv);
+  if (state->ctx_initialized) {
+    EVP_AEAD_CTX_cleanup(&state->ctx);
+    state->ctx_initialized = false;
+  }
+  // `key` is followed by the salt, which libsrtp folds into the IV itself.
+  if (!EVP_AEAD_CTX_init(&state->ctx, state->aead, key, state->key_size,
+                         state->tag_len, nullptr)) {
+    return srtp_err_status_init_fail;
+  }
+  state->ctx_initialized = true;
+  return srtp_err_status_ok;
+}
+
+srtp_err_status_t AeadSetIv(void* cv,
+                            uint8_t* iv,
+                            srtp_cipher_direction_t direction) {
+  AeadCipherState* state = static_cast<AeadCipherState*>(cv);
+  if (direction != srtp_direction_encrypt &&
+      direction != srtp_direction_decrypt) {
+    return srtp_err_status_bad_param;
+  }
+  memcpy(state->iv, iv, kGcmIvLength);
+  state->direction = direction;
+  state->aad.clear();
+  return srtp_err_status_ok;
+}
+
+srtp_err_status_t AeadSetAad(void* cv, const uint8_t* aad, uint32_t aad_len) {
+  AeadCipherState* state = static_cast<AeadCipherState*>(cv);
+  state->aad.insert(state->aad.end(), aad, aad + aad_len);
+  return srtp_err_status_ok;
+}
+
+srtp_err_status_t AeadEncrypt(void* cv,
+                              uint8_t* buffer,
+                              unsigned int* octets_to_encrypt) {
+  AeadCipherState* state = static_cast<AeadCipherState*>(cv);
+  if (state->direction != srtp_direction_encrypt) {
+    return srtp_err_status_bad_param;
+  }
+  size_t tag_len = 0;
+  // In place; the tag is returned separately through get_tag().
+  if (!EVP_AEAD_CTX_seal_scatter(
+          &state->ctx, buffer, state->tag, &tag_len, sizeof(state->tag),
+          state->iv, kGcmIvLength, buffer, *octets_to_encrypt,
+          /*extra_in=*/nullptr, /*extra_in_len=*/0, state->aad.data(),
+          state->aad.size())) {
+    return srtp_err_status_cipher_fail;
+  }
+  RTC_DCHECK_EQ(tag_len, state->tag_len);
+  state->aad.clear();
+  return srtp_err_status_ok;
+}
+
+srtp_err_status_t AeadGetTag(void* cv, uint8_t* tag, uint32_t* len) {
+  AeadCipherState* state = static_cast<AeadCipherState*>(cv);
+  memcpy(tag, state->tag, state->tag_len);
+  *len = static_cast<uint32_t>(state->tag_len);
+  return srtp_err_status_ok;
+}
+
+srtp_err_status_t AeadDecrypt(void* cv,
+                              uint8_t* buffer,
+                              unsigned int* octets_to_decrypt) {
+  AeadCipherState* state = static_cast<AeadCipherState*>(cv);
+  if (state->direction != srtp_direction_decrypt) {
+    return srtp_err_status_bad_param;
+  }
+  if (*octets_to_decrypt < state->tag_len) {
+    return srtp_err_status_bad_param;
+  }
+  // `buffer` holds the ciphertext followed by the tag.
+  size_t out_len = 0;
+  if (!EVP_AEAD_CTX_open(&state->ctx, buffer, &out_len, *octets_to_decrypt,
+                         state->iv, kGcmIvLength, buffer, *octets_to_decrypt,
+                         state->aad.data(), state->aad.size())) {
+    state->aad.clear();
+    return srtp_err_status_auth_fail;
+  }
+  state->aad.clear();
+  *octets_to_decrypt = static_cast<unsigned int>(out_len);
+  return srtp_err_status_ok;
+}
+
+// Known answer tests from "The Galois/Counter Mode of Operation (GCM)"
+// (McGrew, Viega), test cases 4 and 16. libsrtp runs them when the cipher
+// type is registered. The keys carry 12 trailing salt bytes, which the cipher
+// ignores, to match libsrtp's key length convention.
+const uint8_t kGcmTestKey128[SRTP_AES_GCM_128_KEY_LEN_WSALT] = {
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+    0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+    0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+    0x11, 0x12, 0x13, 0x14,
+};
+
+const uint8_t kGcmTestKey256[SRTP_AES_GCM_256_KEY_LEN_WSALT] = {
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+    0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+    0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+    0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+    0x11, 0x12, 0x13, 0x14,
+};
+
+uint8_t kGcmTestIv[kGcmIvLength] = {
+    0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+    0xde, 0xca, 0xf8, 0x88,
+};
+
+const uint8_t kGcmTestPlaintext[60] = {
+    0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+    0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+    0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+    0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+    0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+    0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+    0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+    0xba, 0x63, 0x7b, 0x39,
+};
+
+const uint8_t kGcmTestAad[20] = {
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+    0xab, 0xad, 0xda, 0xd2,
+};
+
+// Ciphertext followed by the 16 byte tag.
+const uint8_t kGcmTestCiphertext128[76] = {
+    0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24,
+    0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+    0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+    0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+    0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c,
+    0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+    0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97,
+    0x3d, 0x58, 0xe0, 0x91, 0x5b, 0xc9, 0x4f, 0xbc,
+    0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a,
+    0xe7, 0x12, 0x1a, 0x47,
+};
+
+const uint8_t kGcmTestCiphertext256[76] = {
+    0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07,
+    0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42, 0x7d,
+    0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9,
+    0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa,
+    0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d,
+    0xa7, 0xb0, 0x8b, 0x10, 0x56, 0x82, 0x88, 0x38,
+    0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a,
+    0xbc, 0xc9, 0xf6, 0x62, 0x76, 0xfc, 0x6e, 0xce,
+    0x0f, 0x4e, 0x17, 0x68, 0xcd, 0xdf, 0x88, 0x53,
+    0xbb, 0x2d, 0x55, 0x1b,
+};
+
+const srtp_cipher_test_case_t kGcmTestCase128 = {
+    SRTP_AES_GCM_128_KEY_LEN_WSALT,  // key_length_octets
+    kGcmTestKey128,                  // key
+    kGcmTestIv,                      // idx
+    sizeof(kGcmTestPlaintext),       // plaintext_length_octets
+    kGcmTestPlaintext,               // plaintext
+    sizeof(kGcmTestCiphertext128),   // ciphertext_length_octets
+    kGcmTestCiphertext128,           // ciphertext
+    sizeof(kGcmTestAad),             // aad_length_octets
+    kGcmTestAad,                     // aad
+    kMaxGcmTagLength,                // tag_length_octets
+    nullptr                          // next_test_case
+};
+
+const srtp_cipher_test_case_t kGcmTestCase256 = {
+    SRTP_AES_GCM_256_KEY_LEN_WSALT,  // key_length_octets
+    kGcmTestKey256,                  // key
+    kGcmTestIv,                      // idx
+    sizeof(kGcmTestPlaintext),       // plaintext_length_octets
+    kGcmTestPlaintext,               // plaintext
+    sizeof(kGcmTestCiphertext256),   // ciphertext_length_octets
+    kGcmTestCiphertext256,           // ciphertext
+    sizeof(kGcmTestAad),             // aad_length_octets
+    kGcmTestAad,                     // aad
+    kMaxGcmTagLength,                // tag_length_octets
+    nullptr                          // next_test_case
+};
+
+const srtp_cipher_type_t kAeadAes128GcmCipher = {
+    AeadAlloc,
+    AeadDealloc,
+    AeadInit,
+    AeadSetAad,
+    AeadEncrypt,
+    AeadDecrypt,
+    AeadSetIv,
+    AeadGetTag,
+    "AES-128 GCM using BoringSSL EVP_AEAD",
+    &kGcmTestCase128,
+    SRTP_AES_GCM_128,
+};
+
+const srtp_cipher_type_t kAeadAes256GcmCipher = {
+    AeadAlloc,
+    AeadDealloc,
+    AeadInit,
+    AeadSetAad,
+    AeadEncrypt,
+    AeadDecrypt,
+    AeadSetIv,
+    AeadGetTag,
+    "AES-256 GCM using BoringSSL EVP_AEAD",
+    &kGcmTestCase256,
+    SRTP_AES_GCM_256,
+};
+
+bool InstallBoringSslAead() {
+  // srtp_crypto_kernel_replace_cipher_type() runs the test vectors above
+  // before swapping the cipher in.
+  srtp_err_status_t err = srtp_crypto_kernel_replace_cipher_type(
+      &kAeadAes128GcmCipher, SRTP_AES_GCM_128);
+  if (err != srtp_err_status_ok) {
+    RTC_LOG(LS_WARNING) << "AES-128-GCM AEAD backend rejected, err=" << err;
+    return false;
+  }
+  err = srtp_crypto_kernel_replace_cipher_type(&kAeadAes256GcmCipher,
+                                               SRTP_AES_GCM_256);
+  if (err != srtp_err_status_ok) {
+    // Only the 128 bit cipher was swapped, which is still consistent: each
+    // suite uses exactly one implementation.
+    RTC_LOG(LS_WARNING) << "AES-256-GCM AEAD backend rejected, err=" << err;
+  }
+  return true;
+}
+
+#endif  // defined(OPENSSL_IS_BORINGSSL)
+
+}  // namespace
+
+const char* SrtpCryptoBackendToString(SrtpCryptoBackend backend) {
+  switch (backend) {
+    case SrtpCryptoBackend::kLibsrtp:
+      return "libsrtp";
+    case SrtpCryptoBackend::kBoringSslAead:
+      return "boringssl-aead";
+  }
+  RTC_NOTREACHED();
+  return "unknown";
+}
+
+SrtpCryptoBackend InstallSrtpCryptoBackend() {
+#if defined(OPENSSL_IS_BORINGSSL)
+  // Without AES instructions BoringSSL falls back to a constant time software
+  // AES that is not faster than libsrtp's, so only switch when it pays off.
+  if (EVP_has_aes_hardware() && InstallBoringSslAead()) {
+    g_srtp_crypto_backend = SrtpCryptoBackend::kBoringSslAead;
+  }
+#endif
+  RTC_LOG(LS_INFO) << "SRTP AEAD backend: "
+                   << SrtpCryptoBackendToString(g_srtp_crypto_backend);
+  return g_srtp_crypto_backend;
+}
+
+SrtpCryptoBackend GetSrtpCryptoBackend() {
+  return g_srtp_crypto_backend;
+}
+
+}  // namespace libp2p_peerconnection
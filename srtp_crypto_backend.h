@@ -0,0 +1,50 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_SRTP_CRYPTO_BACKEND_H_
+#define _C_PC_SRTP_CRYPTO_BACKEND_H_
+
+namespace libp2p_peerconnection {
+
+// Implementation used by libsrtp for the AEAD_AES_128_GCM and
+// AEAD_AES_256_GCM crypto suites.
+enum class SrtpCryptoBackend {
+  // libsrtp's own cipher, whatever it was built with.
+  kLibsrtp,
+  // BoringSSL's EVP_AEAD one-shot seal/open, which uses AES-NI/VAES and
+  // PCLMULQDQ (or the ARMv8 crypto extensions) when the CPU has them.
+  kBoringSslAead,
+};
+
+const char* SrtpCryptoBackendToString(SrtpCryptoBackend backend);
+
+// Picks the AEAD backend for this CPU and registers it with libsrtp in place
+// of the built-in AES-GCM cipher types. libsrtp runs the cipher's known answer
+// tests while registering it; if they fail the built-in cipher is kept.
+//
+// Must be called once, after srtp_init() and before any session is created.
+// SrtpSession does this as part of the one-time libsrtp initialization.
+SrtpCryptoBackend InstallSrtpCryptoBackend();
+
+// The backend chosen by InstallSrtpCryptoBackend().
+SrtpCryptoBackend GetSrtpCryptoBackend();
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_SRTP_CRYPTO_BACKEND_H_
@@ -21,11 +21,15 @@
 
 #include "libp2p_peerconnection/srtp_session.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 
 #include "absl/base/attributes.h"
+#include "absl/base/call_once.h"
 #include "api/array_view.h"
 #include "libmedia_transfer_protocol/rtp_rtcp/rtp_util.h"
+#include "libp2p_peerconnection/srtp_crypto_backend.h"
 #include "pc/external_hmac.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ssl_stream_adapter.h"
@@ -135,6 +139,93 @@ bool SrtpSession::ProtectRtp(void* p,
   return (index) ? GetSendStreamPacketIndex(p, in_len, index) : true;
 }
 
+size_t SrtpSession::ProtectRtpBatch(rtc::ArrayView<PacketRef> packets,
+                                    rtc::ArrayView<int> results) {
+  RTC_DCHECK(thread_checker_.IsCurrent());
+  RTC_DCHECK_EQ(packets.size(), results.size());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to protect SRTP packets: no SRTP Session";
+    std::fill(results.begin(), results.end(),
+              static_cast<int>(srtp_err_status_fail));
+    return 0;
+  }
+
+  size_t num_protected = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    PacketRef& packet = packets[i];
+    // Same headroom rule as ProtectRtp().
+    if (packet.max_len < packet.len + rtp_auth_tag_len_) {
+      results[i] = srtp_err_status_bad_param;
+      continue;
+    }
+    if (dump_plain_rtp_) {
+      DumpPacket(packet.data, packet.len, /*outbound=*/true);
+    }
+    const int in_len = packet.len;
+    int err = srtp_protect(session_, packet.data, &packet.len);
+    if (err == srtp_err_status_ok && packet.index &&
+        !GetSendStreamPacketIndex(packet.data, in_len, packet.index)) {
+      err = srtp_err_status_fail;
+    }
+    results[i] = err;
+    if (err != srtp_err_status_ok) {
+      packet.len = in_len;
+      continue;
+    }
+    last_send_seq_num_ = libmedia_transfer_protocol::ParseRtpSequenceNumber(
+        rtc::MakeArrayView(reinterpret_cast<const uint8_t*>(packet.data),
+                           in_len));
+    ++num_protected;
+  }
+  if (num_protected != packets.size()) {
+    RTC_LOG(LS_WARNING) << "Failed to protect "
+                        << packets.size() - num_protected << " of "
+                        << packets.size()
+                        << " SRTP packets, last seqnum=" << last_send_seq_num_;
+  }
+  return num_protected;
+}
+
+size_t SrtpSession::UnprotectRtpBatch(rtc::ArrayView<PacketRef> packets,
+                                      rtc::ArrayView<int> results) {
+  RTC_DCHECK(thread_checker_.IsCurrent());
+  RTC_DCHECK_EQ(packets.size(), results.size());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packets: no SRTP Session";
+    std::fill(results.begin(), results.end(),
+              static_cast<int>(srtp_err_status_fail));
+    return 0;
+  }
+
+  size_t num_unprotected = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    PacketRef& packet = packets[i];
+    const int in_len = packet.len;
+    const int err = srtp_unprotect(session_, packet.data, &packet.len);
+    results[i] = err;
+    if (err != srtp_err_status_ok) {
+      packet.len = in_len;
+      // Limit the error logging to avoid excessive logs when there are lots
+      // of bad packets.
+      const int kFailureLogThrottleCount = 100;
+      if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
+        RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packet, err=" << err
+                            << ", previous failure count: "
+                            << decryption_failure_count_;
+      }
+      ++decryption_failure_count_;
+      RTC_HISTOGRAM_ENUMERATION("WebRTC.PeerConnection.SrtpUnprotectError",
+                                err, kSrtpErrorCodeBoundary);
+      continue;
+    }
+    if (dump_plain_rtp_) {
+      DumpPacket(packet.data, packet.len, /*outbound=*/false);
+    }
+    ++num_unprotected;
+  }
+  return num_unprotected;
+}
+
 bool SrtpSession::ProtectRtcp(void* p, int in_len, int max_len, int* out_len) {
   RTC_DCHECK(thread_checker_.IsCurrent());
   if (!session_) {
@@ -381,54 +472,69 @@ bool SrtpSession::UpdateKey(int type,
   return DoSetKey(type, cs, key, len, extension_ids);
 }
 
-ABSL_CONST_INIT int g_libsrtp_usage_count = 0;
-ABSL_CONST_INIT webrtc::GlobalMutex g_libsrtp_lock(absl::kConstInit);
+// libsrtp is initialized once per process and never shut down again: an
+// srtp_shutdown()/srtp_init() cycle every time the last session goes away
+// (e.g. when all peer connections reconnect after a network blip) would
+// serialize session setup behind a global lock. After the one-time init the
+// usage count is a plain atomic, so creating and destroying sessions on many
+// threads doesn't contend.
+ABSL_CONST_INIT absl::once_flag g_libsrtp_init_once;
+ABSL_CONST_INIT bool g_libsrtp_init_ok = false;
+ABSL_CONST_INIT std::atomic<bool> g_libsrtp_init_prohibited{false};
+ABSL_CONST_INIT std::atomic<int> g_libsrtp_usage_count{0};
 
 void ProhibitLibsrtpInitialization() {
-  webrtc::GlobalMutexLock ls(&g_libsrtp_lock);
-  ++g_libsrtp_usage_count;
+  g_libsrtp_init_prohibited.store(true, std::memory_order_relaxed);
 }
 
 // static
-bool SrtpSession::IncrementLibsrtpUsageCountAndMaybeInit() {
-  webrtc::GlobalMutexLock ls(&g_libsrtp_lock);
+void SrtpSession::InitLibsrtpOnce() {
+  if (g_libsrtp_init_prohibited.load(std::memory_order_relaxed)) {
+    // Somebody else owns libsrtp initialization.
+    g_libsrtp_init_ok = true;
+    return;
+  }
 
-  RTC_DCHECK_GE(g_libsrtp_usage_count, 0);
-  if (g_libsrtp_usage_count == 0) {
-    int err;
-    err = srtp_init();
-    if (err != srtp_err_status_ok) {
-      RTC_LOG(LS_ERROR) << "Failed to init SRTP, err=" << err;
-      return false;
-    }
+  int err;
+  err = srtp_init();
+  if (err != srtp_err_status_ok) {
+    RTC_LOG(LS_ERROR) << "Failed to init SRTP, err=" << err;
+    return;
+  }
 
-    err = srtp_install_event_handler(&SrtpSession::HandleEventThunk);
-    if (err != srtp_err_status_ok) {
-      RTC_LOG(LS_ERROR) << "Failed to install SRTP event handler, err=" << err;
-      return false;
-    }
+  err = srtp_install_event_handler(&SrtpSession::HandleEventThunk);
+  if (err != srtp_err_status_ok) {
+    RTC_LOG(LS_ERROR) << "Failed to install SRTP event handler, err=" << err;
+    return;
+  }
 
-    err = external_crypto_init();
-    if (err != srtp_err_status_ok) {
-      RTC_LOG(LS_ERROR) << "Failed to initialize fake auth, err=" << err;
-      return false;
-    }
+  err = external_crypto_init();
+  if (err != srtp_err_status_ok) {
+    RTC_LOG(LS_ERROR) << "Failed to initialize fake auth, err=" << err;
+    return;
   }
-  ++g_libsrtp_usage_count;
+
+  // Swap in a faster AES-GCM implementation if this CPU supports one.
+  InstallSrtpCryptoBackend();
+  g_libsrtp_init_ok = true;
+}
+
+// static
+bool SrtpSession::IncrementLibsrtpUsageCountAndMaybeInit() {
+  // call_once also publishes `g_libsrtp_init_ok` to every caller.
+  absl::call_once(g_libsrtp_init_once, &SrtpSession::InitLibsrtpOnce);
+  if (!g_libsrtp_init_ok) {
+    return false;
+  }
+  g_libsrtp_usage_count.fetch_add(1, std::memory_order_relaxed);
   return true;
 }
 
 // static
 void SrtpSession::DecrementLibsrtpUsageCountAndMaybeDeinit() {
-  webrtc::GlobalMutexLock ls(&g_libsrtp_lock);
-
-  RTC_DCHECK_GE(g_libsrtp_usage_count, 1);
-  if (--g_libsrtp_usage_count == 0) {
-    int err = srtp_shutdown();
-    if (err) {
-      RTC_LOG(LS_ERROR) << "srtp_shutdown failed. err=" << err;
-    }
-  }
+  const int previous_count =
+      g_libsrtp_usage_count.fetch_sub(1, std::memory_order_relaxed);
+  RTC_DCHECK_GE(previous_count, 1);
 }
 
 void SrtpSession::HandleEvent(const srtp_event_data_t* ev) {
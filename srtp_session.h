@@ -24,10 +24,10 @@
 
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/scoped_refptr.h"
 #include "api/sequence_checker.h"
 #include "rtc_base/constructor_magic.h"
-#include "rtc_base/synchronization/mutex.h"
 
 // Forward declaration to avoid pulling in libsrtp headers here
 struct srtp_event_data_t;
@@ -83,6 +83,27 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // One packet of a ProtectRtpBatch()/UnprotectRtpBatch() call. `len` is the
+  // input length and is replaced by the output length on success.
+  struct PacketRef {
+    void* data = nullptr;
+    int len = 0;
+    // Buffer capacity, only used when protecting.
+    int max_len = 0;
+    // If set, receives the send stream packet index (protect only).
+    int64_t* index = nullptr;
+  };
+
+  // Batched versions of ProtectRtp()/UnprotectRtp(). The packets are handled
+  // in order and in place; the thread and session checks are done once per
+  // call. `results` must be as long as `packets` and receives the libsrtp
+  // status of each packet (0 is srtp_err_status_ok), so a bad packet doesn't
+  // fail the rest of the burst. Returns the number of packets that succeeded.
+  size_t ProtectRtpBatch(rtc::ArrayView<PacketRef> packets,
+                         rtc::ArrayView<int> results);
+  size_t UnprotectRtpBatch(rtc::ArrayView<PacketRef> packets,
+                           rtc::ArrayView<int> results);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
@@ -124,13 +145,15 @@ class SrtpSession {
   // for debugging.
   void DumpPacket(const void* buf, int len, bool outbound);
 
-  // These methods are responsible for initializing libsrtp (if the usage count
-  // is incremented from 0 to 1) or deinitializing it (when decremented from 1
-  // to 0).
+  // These methods track the number of sessions using libsrtp. The first call
+  // initializes libsrtp once for the lifetime of the process; after that
+  // neither method takes a lock. libsrtp is not deinitialized when the count
+  // drops back to 0.
   //
   // Returns true if successful (will always be successful if already inited).
   static bool IncrementLibsrtpUsageCountAndMaybeInit();
   static void DecrementLibsrtpUsageCountAndMaybeDeinit();
+  static void InitLibsrtpOnce();
 
   void HandleEvent(const srtp_event_data_t* ev);
   static void HandleEventThunk(srtp_event_data_t* ev);
@@ -146,7 +169,6 @@ class SrtpSession {
   int rtcp_auth_tag_len_ = 0;
 
   bool inited_ = false;
-  static webrtc::GlobalMutex lock_;
   int last_send_seq_num_ = -1;
   bool external_auth_active_ = false;
   bool external_auth_enabled_ = false;
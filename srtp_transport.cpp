@@ -29,6 +29,7 @@
 #include "absl/strings/match.h"
 #include "libmedia_transfer_protocol/rtp_utils.h"
 #include "libmedia_transfer_protocol/rtp_rtcp/rtp_util.h"
+#include "libp2p_peerconnection/packet_buffer_pool.h"
 #include "libp2p_peerconnection/rtp_transport.h"
 #include "libp2p_peerconnection/srtp_session.h"
 #include "rtc_base/async_packet_socket.h"
@@ -140,7 +141,7 @@ bool SrtpTransport::SendRtpPacket(rtc::CopyOnWriteBuffer* packet,
   rtc::PacketOptions updated_options = options;
   TRACE_EVENT0("webrtc", "SRTP Encode");
   bool res;
-  uint8_t* data = packet->MutableData();
+  uint8_t* data = PrepareRtpPacketForProtect(packet);
   int len = rtc::checked_cast<int>(packet->size());
 // If ENABLE_EXTERNAL_AUTH flag is on then packet authentication is not done
 // inside libsrtp for a RTP packet. A external HMAC module will be writing
@@ -185,6 +186,70 @@ bool SrtpTransport::SendRtpPacket(rtc::CopyOnWriteBuffer* packet,
   return SendPacket(/*rtcp=*/false, packet, updated_options, flags);
 }
 
+size_t SrtpTransport::SendRtpPackets(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer* const> packets,
+    const rtc::PacketOptions& options,
+    int flags) {
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_ERROR)
+        << "Failed to send the packets because SRTP transport is inactive.";
+    return 0;
+  }
+#if defined(ENABLE_EXTERNAL_AUTH)
+  // The auth params are per packet.
+  if (IsExternalAuthActive()) {
+    return RtpTransport::SendRtpPackets(packets, options, flags);
+  }
+#endif
+  TRACE_EVENT1("webrtc", "SRTP Encode Batch", "size", packets.size());
+  RTC_CHECK(send_session_);
+  protect_refs_.resize(packets.size());
+  protect_results_.resize(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    rtc::CopyOnWriteBuffer* packet = packets[i];
+    protect_refs_[i].data = PrepareRtpPacketForProtect(packet);
+    protect_refs_[i].len = rtc::checked_cast<int>(packet->size());
+    protect_refs_[i].max_len = rtc::checked_cast<int>(packet->capacity());
+  }
+  send_session_->ProtectRtpBatch(protect_refs_, protect_results_);
+  size_t num_sent = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    rtc::CopyOnWriteBuffer* packet = packets[i];
+    if (protect_results_[i] != 0) {
+      RTC_LOG(LS_ERROR) << "Failed to protect RTP packet: size="
+                        << packet->size() << ", seqnum="
+                        << libmedia_transfer_protocol::ParseRtpSequenceNumber(*packet)
+                        << ", SSRC=" << libmedia_transfer_protocol::ParseRtpSsrc(*packet)
+                        << ", err=" << protect_results_[i];
+      continue;
+    }
+    packet->SetSize(protect_refs_[i].len);
+    if (SendPacket(/*rtcp=*/false, packet, options, flags)) {
+      ++num_sent;
+    }
+  }
+  return num_sent;
+}
+
+uint8_t* SrtpTransport::PrepareRtpPacketForProtect(
+    rtc::CopyOnWriteBuffer* packet) {
+  ++send_buffer_stats_.packets;
+  if (packet->capacity() < packet->size() + kSrtpMaxRtpTrailerLen) {
+    // No room for the auth tag, the buffer has to be regrown.
+    packet->EnsureCapacity(packet->size() + kSrtpMaxRtpTrailerLen);
+    ++send_buffer_stats_.allocations;
+    ++send_buffer_stats_.copies;
+  }
+  const uint8_t* shared_data = packet->cdata();
+  uint8_t* data = packet->MutableData();
+  if (data != shared_data) {
+    // The buffer was still referenced elsewhere and has been cloned.
+    ++send_buffer_stats_.allocations;
+    ++send_buffer_stats_.copies;
+  }
+  return data;
+}
+
 bool SrtpTransport::SendRtcpPacket(rtc::CopyOnWriteBuffer* packet,
                                    const rtc::PacketOptions& options,
                                    int flags) {
@@ -218,26 +283,68 @@ void SrtpTransport::OnRtpPacketReceived(rtc::CopyOnWriteBuffer packet,
         << "Inactive SRTP transport received an RTP packet. Drop it.";
     return;
   }
-  char* data = packet.MutableData<char>();
-  int len = rtc::checked_cast<int>(packet.size());
-  if (!UnprotectRtp(data, len, &len)) {
-    // Limit the error logging to avoid excessive logs when there are lots of
-    // bad packets.
-    const int kFailureLogThrottleCount = 100;
-    if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
-      RTC_LOG(LS_ERROR) << "Failed to unprotect RTP packet: size=" << len
-                        << ", seqnum=" << libmedia_transfer_protocol::ParseRtpSequenceNumber(packet)
-                        << ", SSRC=" << libmedia_transfer_protocol::ParseRtpSsrc(packet)
-                        << ", previous failure count: "
-                        << decryption_failure_count_;
-    }
-    ++decryption_failure_count_;
+  if (!UnprotectRtpPacket(&packet)) {
     return;
   }
-  packet.SetSize(len);
   DemuxPacket(std::move(packet), packet_time_us);
 }
 
+void SrtpTransport::OnRtpPacketsReceived(
+    std::vector<ReceivedRtpPacket>* packets) {
+  TRACE_EVENT1("webrtc", "SrtpTransport::OnRtpPacketsReceived", "size",
+               packets->size());
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_WARNING) << "Inactive SRTP transport received "
+                        << packets->size() << " RTP packets. Drop them.";
+    return;
+  }
+  RTC_CHECK(recv_session_);
+  // Unprotect the whole burst in one session call, then demux the packets
+  // that passed.
+  unprotect_refs_.resize(packets->size());
+  unprotect_results_.resize(packets->size());
+  for (size_t i = 0; i < packets->size(); ++i) {
+    rtc::CopyOnWriteBuffer& packet = (*packets)[i].packet;
+    unprotect_refs_[i].data = packet.MutableData();
+    unprotect_refs_[i].len = rtc::checked_cast<int>(packet.size());
+  }
+  recv_session_->UnprotectRtpBatch(unprotect_refs_, unprotect_results_);
+  for (size_t i = 0; i < packets->size(); ++i) {
+    ReceivedRtpPacket& received = (*packets)[i];
+    if (unprotect_results_[i] != 0) {
+      OnUnprotectRtpFailed(received.packet);
+      continue;
+    }
+    received.packet.SetSize(unprotect_refs_[i].len);
+    DemuxPacket(std::move(received.packet), received.packet_time_us);
+  }
+}
+
+bool SrtpTransport::UnprotectRtpPacket(rtc::CopyOnWriteBuffer* packet) {
+  char* data = packet->MutableData<char>();
+  int len = rtc::checked_cast<int>(packet->size());
+  if (!UnprotectRtp(data, len, &len)) {
+    OnUnprotectRtpFailed(*packet);
+    return false;
+  }
+  packet->SetSize(len);
+  return true;
+}
+
+void SrtpTransport::OnUnprotectRtpFailed(const rtc::CopyOnWriteBuffer& packet) {
+  // Limit the error logging to avoid excessive logs when there are lots of
+  // bad packets.
+  const int kFailureLogThrottleCount = 100;
+  if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
+    RTC_LOG(LS_ERROR) << "Failed to unprotect RTP packet: size=" << packet.size()
+                      << ", seqnum=" << libmedia_transfer_protocol::ParseRtpSequenceNumber(packet)
+                      << ", SSRC=" << libmedia_transfer_protocol::ParseRtpSsrc(packet)
+                      << ", previous failure count: "
+                      << decryption_failure_count_;
+  }
+  ++decryption_failure_count_;
+}
+
 void SrtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer packet,
                                          int64_t packet_time_us) {
   TRACE_EVENT0("webrtc", "SrtpTransport::OnRtcpPacketReceived");
@@ -257,6 +364,7 @@ void SrtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer packet,
   }
   packet.SetSize(len);
   SignalRtcpPacketReceived(&packet, packet_time_us);
+  PacketBufferPool::Current()->Release(std::move(packet));
 }
 
 void SrtpTransport::OnNetworkRouteChanged(
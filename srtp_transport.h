@@ -41,6 +41,23 @@
 
 namespace libp2p_peerconnection {
 
+// Largest trailer libsrtp appends to an RTP packet: a 16 byte auth tag
+// (AES-GCM or HMAC-SHA1-80 both fit) plus a 4 byte MKI. Outgoing RTP buffers
+// must have at least this much spare capacity to be protected in place.
+constexpr size_t kSrtpMaxRtpTrailerLen = 16 + 4;
+
+// Counters for the outgoing RTP buffers seen by SendRtpPacket(). A send path
+// that hands over uniquely owned buffers with enough capacity keeps
+// `allocations` and `copies` at zero.
+struct SrtpSendBufferStats {
+  int64_t packets = 0;
+  // Buffers that had to be (re)allocated before they could be protected.
+  int64_t allocations = 0;
+  // Buffers whose payload was memcpy'd, either because the buffer was shared
+  // (copy-on-write) or because it had no room for the SRTP trailer.
+  int64_t copies = 0;
+};
+
 // This subclass of the RtpTransport is used for SRTP which is reponsible for
 // protecting/unprotecting the packets. It provides interfaces to set the crypto
 // parameters for the SrtpSession underneath.
@@ -62,6 +79,12 @@ class SrtpTransport : public RtpTransport {
                       const rtc::PacketOptions& options,
                       int flags) override;
 
+  // Protects the whole burst in one SrtpSession::ProtectRtpBatch() call,
+  // then sends the packets that succeeded.
+  size_t SendRtpPackets(rtc::ArrayView<rtc::CopyOnWriteBuffer* const> packets,
+                        const rtc::PacketOptions& options,
+                        int flags) override;
+
   // The transport becomes active if the send_session_ and recv_session_ are
   // created.
   bool IsSrtpActive() const override;
@@ -119,10 +142,20 @@ class SrtpTransport : public RtpTransport {
     rtp_abs_sendtime_extn_id_ = rtp_abs_sendtime_extn_id;
   }
 
+  const SrtpSendBufferStats& send_buffer_stats() const {
+    return send_buffer_stats_;
+  }
+
  protected:
   // If the writable state changed, fire the SignalWritableState.
   void MaybeUpdateWritableState();
 
+  // True if RTCP has its own sessions; otherwise RTCP is protected with the
+  // RTP sessions.
+  bool HasSrtcpSessions() const {
+    return send_rtcp_session_ && recv_rtcp_session_;
+  }
+
  private:
   void ConnectToRtpTransport();
   void CreateSrtpSessions();
@@ -131,6 +164,14 @@ class SrtpTransport : public RtpTransport {
                            int64_t packet_time_us) override;
   void OnRtcpPacketReceived(rtc::CopyOnWriteBuffer packet,
                             int64_t packet_time_us) override;
+  void OnRtpPacketsReceived(std::vector<ReceivedRtpPacket>* packets) override;
+  // Unprotects `packet` in place and shrinks it to the decrypted size.
+  bool UnprotectRtpPacket(rtc::CopyOnWriteBuffer* packet);
+  // Throttled log of a packet that failed to unprotect; counts the failure.
+  void OnUnprotectRtpFailed(const rtc::CopyOnWriteBuffer& packet);
+  // Makes `packet` uniquely owned with room for the SRTP trailer, counting
+  // the allocations and copies that takes, and returns its data.
+  uint8_t* PrepareRtpPacketForProtect(rtc::CopyOnWriteBuffer* packet);
   void OnNetworkRouteChanged(
       absl::optional<rtc::NetworkRoute> network_route) override;
 
@@ -177,6 +218,15 @@ class SrtpTransport : public RtpTransport {
   int rtp_abs_sendtime_extn_id_ = -1;
 
   int decryption_failure_count_ = 0;
+
+  // Scratch space of OnRtpPacketsReceived() and SendRtpPackets(), kept to
+  // avoid reallocating.
+  std::vector<SrtpSession::PacketRef> unprotect_refs_;
+  std::vector<int> unprotect_results_;
+  std::vector<SrtpSession::PacketRef> protect_refs_;
+  std::vector<int> protect_results_;
+
+  SrtpSendBufferStats send_buffer_stats_;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,164 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/transport_feedback_generator.h"
+
+#include <limits>
+#include <utility>
+
+#include "api/units/timestamp.h"
+#include "libmedia_transfer_protocol/rtp_rtcp/rtcp_packet/transport_feedback.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+constexpr int32_t kNotReceived = std::numeric_limits<int32_t>::min();
+
+}  // namespace
+
+TransportFeedbackGenerator::TransportFeedbackGenerator(
+    rtc::Thread* network_thread,
+    uint32_t sender_ssrc,
+    FeedbackSender feedback_sender)
+    : network_thread_(network_thread),
+      sender_ssrc_(sender_ssrc),
+      feedback_sender_(std::move(feedback_sender)) {
+  RTC_DCHECK(network_thread_);
+  RTC_DCHECK(feedback_sender_);
+}
+
+TransportFeedbackGenerator::~TransportFeedbackGenerator() = default;
+
+void TransportFeedbackGenerator::OnPacketArrived(
+    uint32_t media_ssrc,
+    uint16_t transport_sequence_number,
+    int64_t arrival_time_us) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  ++stats_.received_packets;
+  media_ssrc_ = media_ssrc;
+  const int64_t sequence_number = unwrapper_.Unwrap(transport_sequence_number);
+
+  if (window_begin_sequence_number_ < 0) {
+    ResetWindow(sequence_number, arrival_time_us);
+  } else if (sequence_number < window_begin_sequence_number_) {
+    ++stats_.late_packets;
+    return;
+  } else if (arrival_offsets_us_.empty()) {
+    // Everything before was reported; the offsets start over.
+    window_base_time_us_ = arrival_time_us;
+  }
+
+  int64_t offset_us = arrival_time_us - window_base_time_us_;
+  if (static_cast<uint64_t>(sequence_number - window_begin_sequence_number_) >=
+          kMaxWindowPackets ||
+      offset_us <= kNotReceived ||
+      offset_us > std::numeric_limits<int32_t>::max()) {
+    SendFeedback();
+    ResetWindow(sequence_number, arrival_time_us);
+    offset_us = 0;
+  }
+
+  const size_t index =
+      static_cast<size_t>(sequence_number - window_begin_sequence_number_);
+  if (index >= arrival_offsets_us_.size()) {
+    arrival_offsets_us_.resize(index + 1, kNotReceived);
+  }
+  // Duplicates keep the first arrival time.
+  if (arrival_offsets_us_[index] == kNotReceived) {
+    arrival_offsets_us_[index] = static_cast<int32_t>(offset_us);
+  }
+
+  if (!feedback_scheduled_) {
+    feedback_scheduled_ = true;
+    network_thread_->PostDelayedTask(
+        webrtc::ToQueuedTask(task_safety_,
+                             [this]() {
+                               RTC_DCHECK_RUN_ON(network_thread_);
+                               feedback_scheduled_ = false;
+                               SendFeedback();
+                             }),
+        kFeedbackIntervalMs);
+  }
+}
+
+void TransportFeedbackGenerator::ResetWindow(int64_t sequence_number,
+                                             int64_t arrival_time_us) {
+  window_begin_sequence_number_ = sequence_number;
+  window_base_time_us_ = arrival_time_us;
+  arrival_offsets_us_.clear();
+}
+
+void TransportFeedbackGenerator::SendFeedback() {
+  // The window always ends with a received packet, so each round reports at
+  // least one packet. A round ends early when the feedback packet is full or
+  // a delta does not fit; the rest goes into the next one.
+  while (!arrival_offsets_us_.empty()) {
+    int32_t base_offset_us = kNotReceived;
+    for (int32_t offset_us : arrival_offsets_us_) {
+      if (offset_us != kNotReceived) {
+        base_offset_us = offset_us;
+        break;
+      }
+    }
+    RTC_DCHECK_NE(base_offset_us, kNotReceived);
+
+    libmedia_transfer_protocol::rtcp::TransportFeedback feedback;
+    feedback.SetSenderSsrc(sender_ssrc_);
+    feedback.SetMediaSsrc(media_ssrc_);
+    feedback.SetBase(
+        static_cast<uint16_t>(window_begin_sequence_number_),
+        webrtc::Timestamp::Micros(window_base_time_us_ + base_offset_us));
+    feedback.SetFeedbackSequenceNumber(feedback_sequence_number_++);
+
+    size_t reported = 0;
+    for (; reported < arrival_offsets_us_.size(); ++reported) {
+      const int32_t offset_us = arrival_offsets_us_[reported];
+      if (offset_us == kNotReceived) {
+        continue;
+      }
+      if (!feedback.AddReceivedPacket(
+              static_cast<uint16_t>(window_begin_sequence_number_ + reported),
+              webrtc::Timestamp::Micros(window_base_time_us_ + offset_us))) {
+        break;
+      }
+    }
+    if (reported == 0) {
+      RTC_LOG(LS_WARNING) << "Failed to build transport feedback, dropping "
+                          << arrival_offsets_us_.size() << " packets.";
+      window_begin_sequence_number_ += arrival_offsets_us_.size();
+      arrival_offsets_us_.clear();
+      break;
+    }
+
+    const rtc::Buffer packet = feedback.Build();
+    ++stats_.feedback_packets;
+    feedback_sender_(rtc::CopyOnWriteBuffer(packet.data(), packet.size()));
+
+    arrival_offsets_us_.erase(arrival_offsets_us_.begin(),
+                              arrival_offsets_us_.begin() + reported);
+    window_begin_sequence_number_ += reported;
+  }
+}
+
+}  // namespace libp2p_peerconnection
@@ -0,0 +1,106 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_TRANSPORT_FEEDBACK_GENERATOR_H_
+#define _C_PC_TRANSPORT_FEEDBACK_GENERATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <functional>
+
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/numerics/sequence_number_util.h"
+#include "rtc_base/task_utils/pending_task_safety_flag.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/thread.h"
+
+namespace libp2p_peerconnection {
+
+// Receive side of transport-wide congestion control
+// (draft-holmer-rmcat-transport-wide-cc-extensions-01).
+//
+// Records the arrival time of every packet carrying a transport sequence
+// number and, every kFeedbackIntervalMs, reports them to the sender in
+// RTCP transport feedback packets.
+//
+// Arrival times are kept as 32 bit microsecond offsets from the first packet
+// of the window, one slot per sequence number, so the window costs 4 bytes
+// per packet and gaps need no separate bookkeeping. Reported packets are
+// dropped from the window; packets older than the window are not reported.
+//
+// Lives on the network thread. The timer only runs while there are
+// unreported packets.
+class TransportFeedbackGenerator : public sigslot::has_slots<> {
+ public:
+  static constexpr int kFeedbackIntervalMs = 100;
+  // A larger jump in sequence numbers starts a new window.
+  static constexpr size_t kMaxWindowPackets = 1 << 15;
+
+  // Called with each serialized transport feedback packet.
+  using FeedbackSender = std::function<void(rtc::CopyOnWriteBuffer packet)>;
+
+  struct Stats {
+    int64_t received_packets = 0;
+    int64_t feedback_packets = 0;
+    // Packets that arrived after their sequence number was reported.
+    int64_t late_packets = 0;
+  };
+
+  TransportFeedbackGenerator(rtc::Thread* network_thread,
+                             uint32_t sender_ssrc,
+                             FeedbackSender feedback_sender);
+  ~TransportFeedbackGenerator() override;
+
+  TransportFeedbackGenerator(const TransportFeedbackGenerator&) = delete;
+  TransportFeedbackGenerator& operator=(const TransportFeedbackGenerator&) =
+      delete;
+
+  void OnPacketArrived(uint32_t media_ssrc,
+                       uint16_t transport_sequence_number,
+                       int64_t arrival_time_us);
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  void ResetWindow(int64_t sequence_number, int64_t arrival_time_us);
+  void SendFeedback();
+
+  rtc::Thread* const network_thread_;
+  const uint32_t sender_ssrc_;
+  const FeedbackSender feedback_sender_;
+
+  webrtc::SeqNumUnwrapper<uint16_t> unwrapper_;
+  uint32_t media_ssrc_ = 0;
+  // Unwrapped sequence number of the first slot, -1 while nothing arrived.
+  int64_t window_begin_sequence_number_ = -1;
+  // Reference of the offsets in `arrival_offsets_us_`.
+  int64_t window_base_time_us_ = 0;
+  std::deque<int32_t> arrival_offsets_us_;
+  uint8_t feedback_sequence_number_ = 0;
+  bool feedback_scheduled_ = false;
+  Stats stats_;
+
+  webrtc::ScopedTaskSafety task_safety_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_TRANSPORT_FEEDBACK_GENERATOR_H_
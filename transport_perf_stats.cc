@@ -0,0 +1,147 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/transport_perf_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "rtc_base/strings/string_builder.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+double PerSecond(int64_t value, int64_t elapsed_us) {
+  return elapsed_us > 0 ? value * 1e6 / elapsed_us : 0.0;
+}
+
+double PerPacket(int64_t value, int64_t packets) {
+  return packets > 0 ? static_cast<double>(value) / packets : 0.0;
+}
+
+void AppendCounters(rtc::StringBuilder& sb,
+                    const char* name,
+                    const TransportPerfCounters& counters,
+                    int64_t elapsed_us) {
+  sb << "\"" << name << "\":{"
+     << "\"packets\":" << counters.packets << ","
+     << "\"bytes\":" << counters.bytes << ","
+     << "\"packets_per_second\":"
+     << PerSecond(counters.packets, elapsed_us) << ","
+     << "\"bytes_per_second\":" << PerSecond(counters.bytes, elapsed_us)
+     << ","
+     << "\"latency_us\":{"
+     << "\"p50\":" << counters.latency_us.Percentile(50) << ","
+     << "\"p99\":" << counters.latency_us.Percentile(99) << "}";
+}
+
+}  // namespace
+
+int PacketLatencyHistogram::BucketIndex(uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<int>(value);
+  }
+  int exponent = 0;
+  while ((value >> (exponent + 1)) != 0) {
+    ++exponent;
+  }
+  const int sub_bucket =
+      static_cast<int>((value >> (exponent - kSubBucketBits)) &
+                       (kSubBuckets - 1));
+  const int index = (exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+  return std::min(index, kNumBuckets - 1);
+}
+
+int64_t PacketLatencyHistogram::BucketLowerBound(int index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const int exponent = index / kSubBuckets + kSubBucketBits - 1;
+  const int sub_bucket = index % kSubBuckets;
+  return (int64_t{1} << exponent) +
+         (static_cast<int64_t>(sub_bucket) << (exponent - kSubBucketBits));
+}
+
+void PacketLatencyHistogram::Add(int64_t latency_us) {
+  ++buckets_[BucketIndex(static_cast<uint64_t>(std::max<int64_t>(0, latency_us)))];
+  ++count_;
+}
+
+void PacketLatencyHistogram::Merge(const PacketLatencyHistogram& other) {
+  for (int i = 0; i < kNumBuckets; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+}
+
+int64_t PacketLatencyHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  // Rank of the sample, 1 based.
+  const int64_t rank = std::max<int64_t>(
+      1, static_cast<int64_t>(std::ceil(percentile / 100.0 * count_)));
+  int64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return BucketLowerBound(i);
+    }
+  }
+  return BucketLowerBound(kNumBuckets - 1);
+}
+
+std::string TransportPerfSnapshotToJson(const TransportPerfSnapshot& snapshot) {
+  rtc::StringBuilder sb;
+  sb << "{\"elapsed_ms\":" << snapshot.elapsed_us / 1000 << ",";
+  AppendCounters(sb, "send", snapshot.send, snapshot.elapsed_us);
+  sb << ",\"allocations_per_packet\":"
+     << PerPacket(snapshot.send_allocations, snapshot.send.packets)
+     << ",\"copies_per_packet\":"
+     << PerPacket(snapshot.send_copies, snapshot.send.packets)
+     << ",\"encode_to_wire_latency_us\":{"
+     << "\"p50\":" << snapshot.encode_to_wire_latency_us.Percentile(50) << ","
+     << "\"p99\":" << snapshot.encode_to_wire_latency_us.Percentile(99)
+     << "}},";
+  AppendCounters(sb, "receive", snapshot.receive, snapshot.elapsed_us);
+  sb << "},";
+  sb << "\"rtcp\":{"
+     << "\"packets\":" << snapshot.rtcp_packets << ","
+     << "\"compound_packets\":" << snapshot.rtcp_compound_packets << ","
+     << "\"packets_per_compound\":"
+     << PerPacket(snapshot.rtcp_packets, snapshot.rtcp_compound_packets)
+     << "},";
+  const int64_t pool_total = snapshot.pool_hits + snapshot.pool_misses;
+  sb << "\"buffer_pool\":{"
+     << "\"hits\":" << snapshot.pool_hits << ","
+     << "\"misses\":" << snapshot.pool_misses << ","
+     << "\"miss_rate\":" << PerPacket(snapshot.pool_misses, pool_total) << ","
+     << "\"high_water_mark\":" << snapshot.pool_high_water_mark << "},";
+  const int64_t send_pool_total =
+      snapshot.send_pool_hits + snapshot.send_pool_misses;
+  sb << "\"send_buffer_pool\":{"
+     << "\"hits\":" << snapshot.send_pool_hits << ","
+     << "\"misses\":" << snapshot.send_pool_misses << ","
+     << "\"miss_rate\":"
+     << PerPacket(snapshot.send_pool_misses, send_pool_total) << "}}";
+  return sb.Release();
+}
+
+}  // namespace libp2p_peerconnection
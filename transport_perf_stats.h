@@ -0,0 +1,113 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_TRANSPORT_PERF_STATS_H_
+#define _C_PC_TRANSPORT_PERF_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <string>
+
+namespace libp2p_peerconnection {
+
+// The per-packet latency histograms below cost a clock read per packet on the
+// send and receive paths. They are only recorded when the library is built
+// with ENABLE_TRANSPORT_PERF_LATENCY, which the bench build turns on
+// (LIBP2P_PEERCONNECTION_BUILD_BENCH); packet and byte counts are always kept.
+#if defined(ENABLE_TRANSPORT_PERF_LATENCY)
+constexpr bool kTransportPerfLatencyEnabled = true;
+#else
+constexpr bool kTransportPerfLatencyEnabled = false;
+#endif
+
+// Fixed size log-linear histogram of per-packet latencies in microseconds.
+// Each power of two is split into 8 buckets, so percentiles are accurate to
+// within 12.5%; recording is a couple of shifts and an increment.
+class PacketLatencyHistogram {
+ public:
+  void Add(int64_t latency_us);
+  void Merge(const PacketLatencyHistogram& other);
+  // Returns the lower bound of the bucket holding the `percentile` (0..100)
+  // sample, or 0 if the histogram is empty.
+  int64_t Percentile(double percentile) const;
+  int64_t count() const { return count_; }
+
+ private:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // Covers latencies up to 2^32 us (over an hour).
+  static constexpr int kNumBuckets = (32 - kSubBucketBits + 1) * kSubBuckets;
+
+  static int BucketIndex(uint64_t value);
+  static int64_t BucketLowerBound(int index);
+
+  std::array<int64_t, kNumBuckets> buckets_{};
+  int64_t count_ = 0;
+};
+
+// Throughput counters of one direction of the transport stack.
+struct TransportPerfCounters {
+  int64_t packets = 0;
+  int64_t bytes = 0;
+  // Time from handing a packet to the stack until it left it (socket write
+  // for sending, demuxer sink for receiving).
+  PacketLatencyHistogram latency_us;
+
+  void Merge(const TransportPerfCounters& other) {
+    packets += other.packets;
+    bytes += other.bytes;
+    latency_us.Merge(other.latency_us);
+  }
+};
+
+// Everything transport_controller knows about the cost of moving packets,
+// meant for tracking regressions between releases.
+struct TransportPerfSnapshot {
+  int64_t elapsed_us = 0;
+  TransportPerfCounters send;
+  TransportPerfCounters receive;
+  // Heap allocations and memcpys made on the send path before encryption.
+  int64_t send_allocations = 0;
+  int64_t send_copies = 0;
+  // Packets that carry an encode timestamp (audio), from the encoder
+  // finishing the frame until the socket write.
+  PacketLatencyHistogram encode_to_wire_latency_us;
+  // RTCP packets handed to the controller, and the compound packets they
+  // were coalesced into.
+  int64_t rtcp_packets = 0;
+  int64_t rtcp_compound_packets = 0;
+  // PacketBufferPool of the network thread.
+  int64_t pool_hits = 0;
+  int64_t pool_misses = 0;
+  size_t pool_high_water_mark = 0;
+  // Pool the encoder thread packetizes video into; the network thread hands
+  // the buffers back after sending.
+  int64_t send_pool_hits = 0;
+  int64_t send_pool_misses = 0;
+};
+
+// Single line JSON object, e.g.
+// {"elapsed_ms":1000,"send":{"packets":..,"packets_per_second":..,...}}
+std::string TransportPerfSnapshotToJson(const TransportPerfSnapshot& snapshot);
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_TRANSPORT_PERF_STATS_H_
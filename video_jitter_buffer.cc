@@ -0,0 +1,247 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/video_jitter_buffer.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace libp2p_peerconnection {
+
+namespace {
+
+constexpr int64_t kVideoClockRateKhz = 90;
+
+// Estimator parameters, from the VCMJitterEstimator.
+constexpr double kFrameSizeFilter = 0.97;
+constexpr double kMaxFrameSizeDecay = 0.9999;
+constexpr int kMaxNoiseSamples = 400;
+constexpr double kMinDelayPerByte = 0.000001;
+constexpr double kNumStdDevDelayOutlier = 15.0;
+constexpr double kNumStdDevFrameSizeOutlier = 3.0;
+constexpr double kNoiseStdDevs = 2.33;
+constexpr double kNoiseStdDevOffsetMs = 30.0;
+constexpr double kProcessNoise[2] = {2.5e-10, 1e-10};
+// Frames before the estimate is used.
+constexpr int kStartupDelaySamples = 30;
+
+// Per frame pull of the transit offset towards later samples.
+constexpr double kTransitOffsetRelax = 0.001;
+
+}  // namespace
+
+VideoJitterBuffer::VideoJitterBuffer() = default;
+
+VideoJitterBuffer::~VideoJitterBuffer() = default;
+
+bool VideoJitterBuffer::SetBaseMinimumDelayMs(int delay_ms) {
+  if (delay_ms < 0 || delay_ms > kMaxBaseMinimumDelayMs) {
+    return false;
+  }
+  base_minimum_delay_ms_ = delay_ms;
+  return true;
+}
+
+void VideoJitterBuffer::SetLowLatencyMode(bool enabled) {
+  low_latency_mode_ = enabled;
+}
+
+VideoJitterBuffer::Frames VideoJitterBuffer::InsertFrame(
+    std::shared_ptr<libmedia_codec::EncodedImage> frame,
+    int64_t receive_time_ms,
+    int64_t now_ms) {
+  RTC_DCHECK(frame);
+  ++stats_.frames;
+  const int64_t timestamp_ms =
+      timestamp_unwrapper_.Unwrap(frame->Timestamp()) / kVideoClockRateKhz;
+  const double frame_size = static_cast<double>(frame->size());
+
+  const double transit_ms = static_cast<double>(receive_time_ms - timestamp_ms);
+  if (last_timestamp_ms_ < 0 || transit_ms < transit_offset_ms_) {
+    transit_offset_ms_ = transit_ms;
+  } else {
+    transit_offset_ms_ +=
+        (transit_ms - transit_offset_ms_) * kTransitOffsetRelax;
+  }
+  if (last_timestamp_ms_ >= 0 && timestamp_ms > last_timestamp_ms_) {
+    const int64_t media_interval_ms = timestamp_ms - last_timestamp_ms_;
+    UpdateEstimate(
+        static_cast<double>(receive_time_ms - last_receive_time_ms_ -
+                            media_interval_ms),
+        frame_size - last_frame_size_);
+    UpdateCurrentDelay(media_interval_ms);
+  }
+  last_timestamp_ms_ = timestamp_ms;
+  last_receive_time_ms_ = receive_time_ms;
+  last_frame_size_ = frame_size;
+
+  Frames frames;
+  if (size_ == kMaxFrames) {
+    frames.push_back(PopFront().frame);
+    ++stats_.flushed_frames;
+  }
+  Slot& slot = ring_[(head_ + size_) % kMaxFrames];
+  slot.frame = std::move(frame);
+  slot.playout_time_ms = timestamp_ms +
+                         static_cast<int64_t>(transit_offset_ms_) +
+                         current_delay_ms_;
+  ++size_;
+
+  Frames due = ReleaseFrames(now_ms);
+  if (frames.empty()) {
+    return due;
+  }
+  frames.insert(frames.end(), due.begin(), due.end());
+  return frames;
+}
+
+VideoJitterBuffer::Frames VideoJitterBuffer::ReleaseFrames(int64_t now_ms) {
+  Frames frames;
+  while (size_ > 0 &&
+         (low_latency_mode_ || ring_[head_].playout_time_ms <= now_ms)) {
+    frames.push_back(PopFront().frame);
+  }
+  return frames;
+}
+
+int64_t VideoJitterBuffer::NextReleaseTimeMs() const {
+  return size_ > 0 ? ring_[head_].playout_time_ms : -1;
+}
+
+VideoJitterBuffer::Stats VideoJitterBuffer::stats() const {
+  Stats stats = stats_;
+  stats.jitter_ms = static_cast<int>(JitterMs() + 0.5);
+  stats.target_delay_ms =
+      std::max(base_minimum_delay_ms_, std::min(stats.jitter_ms, kMaxDelayMs));
+  stats.current_delay_ms = current_delay_ms_;
+  return stats;
+}
+
+void VideoJitterBuffer::UpdateEstimate(double frame_delay_ms,
+                                       double frame_size_delta) {
+  const double frame_size = last_frame_size_ + frame_size_delta;
+  // Keyframes would inflate the average size and hide the size related
+  // part of the jitter.
+  if (frame_size < average_frame_size_ + 2 * sqrt(frame_size_variance_)) {
+    average_frame_size_ = kFrameSizeFilter * average_frame_size_ +
+                          (1 - kFrameSizeFilter) * frame_size;
+    const double deviation = frame_size - average_frame_size_;
+    frame_size_variance_ =
+        std::max(kFrameSizeFilter * frame_size_variance_ +
+                     (1 - kFrameSizeFilter) * deviation * deviation,
+                 1.0);
+  }
+  max_frame_size_ = std::max(kMaxFrameSizeDecay * max_frame_size_, frame_size);
+
+  const double residual_ms =
+      frame_delay_ms - (theta_[0] * frame_size_delta + theta_[1]);
+  const double noise_std_dev = sqrt(noise_variance_);
+  if (fabs(residual_ms) >= kNumStdDevDelayOutlier * noise_std_dev &&
+      frame_size <= average_frame_size_ + kNumStdDevFrameSizeOutlier *
+                                              sqrt(frame_size_variance_)) {
+    // An outlier only moves the noise estimate, and by a bounded amount.
+    UpdateNoise(residual_ms >= 0 ? kNumStdDevDelayOutlier * noise_std_dev
+                                 : -kNumStdDevDelayOutlier * noise_std_dev);
+    return;
+  }
+  UpdateNoise(residual_ms);
+  if (delay_samples_ < kStartupDelaySamples) {
+    ++delay_samples_;
+  }
+  if (frame_size_delta <= -0.25 * max_frame_size_ || max_frame_size_ < 1.0) {
+    return;
+  }
+
+  covariance_[0][0] += kProcessNoise[0];
+  covariance_[1][1] += kProcessNoise[1];
+  const double mh[2] = {
+      covariance_[0][0] * frame_size_delta + covariance_[0][1],
+      covariance_[1][0] * frame_size_delta + covariance_[1][1]};
+  const double sigma =
+      std::max((300.0 * exp(-fabs(frame_size_delta) / max_frame_size_) + 1) *
+                   sqrt(noise_variance_),
+               1.0);
+  const double hmh_sigma = frame_size_delta * mh[0] + mh[1] + sigma;
+  if (fabs(hmh_sigma) < 1e-9) {
+    return;
+  }
+  const double gain[2] = {mh[0] / hmh_sigma, mh[1] / hmh_sigma};
+  theta_[0] = std::max(theta_[0] + gain[0] * residual_ms, kMinDelayPerByte);
+  theta_[1] += gain[1] * residual_ms;
+
+  const double p00 = covariance_[0][0];
+  const double p01 = covariance_[0][1];
+  covariance_[0][0] = (1 - gain[0] * frame_size_delta) * p00 -
+                      gain[0] * covariance_[1][0];
+  covariance_[0][1] = (1 - gain[0] * frame_size_delta) * p01 -
+                      gain[0] * covariance_[1][1];
+  covariance_[1][0] =
+      covariance_[1][0] * (1 - gain[1]) - gain[1] * frame_size_delta * p00;
+  covariance_[1][1] =
+      covariance_[1][1] * (1 - gain[1]) - gain[1] * frame_size_delta * p01;
+}
+
+void VideoJitterBuffer::UpdateNoise(double residual_ms) {
+  const double alpha =
+      static_cast<double>(noise_samples_ - 1) / noise_samples_;
+  if (noise_samples_ < kMaxNoiseSamples) {
+    ++noise_samples_;
+  }
+  noise_mean_ms_ = alpha * noise_mean_ms_ + (1 - alpha) * residual_ms;
+  const double deviation = residual_ms - noise_mean_ms_;
+  noise_variance_ = std::max(
+      alpha * noise_variance_ + (1 - alpha) * deviation * deviation, 1.0);
+}
+
+double VideoJitterBuffer::JitterMs() const {
+  if (delay_samples_ < kStartupDelaySamples) {
+    return 0;
+  }
+  const double noise_threshold_ms = std::max(
+      kNoiseStdDevs * sqrt(noise_variance_) - kNoiseStdDevOffsetMs, 1.0);
+  return std::max(
+      theta_[0] * (max_frame_size_ - average_frame_size_) + noise_threshold_ms,
+      0.0);
+}
+
+void VideoJitterBuffer::UpdateCurrentDelay(int64_t media_interval_ms) {
+  const int jitter_ms = static_cast<int>(JitterMs() + 0.5);
+  const int target_delay_ms =
+      std::max(base_minimum_delay_ms_, std::min(jitter_ms, kMaxDelayMs));
+  const int max_change_ms = std::max<int>(
+      static_cast<int>(kMaxDelayChangeMsPerS * media_interval_ms / 1000), 1);
+  current_delay_ms_ += std::max(
+      std::min(target_delay_ms - current_delay_ms_, max_change_ms),
+      -max_change_ms);
+}
+
+VideoJitterBuffer::Slot VideoJitterBuffer::PopFront() {
+  RTC_DCHECK_GT(size_, 0u);
+  Slot slot = std::move(ring_[head_]);
+  ring_[head_].frame = nullptr;
+  head_ = (head_ + 1) % kMaxFrames;
+  --size_;
+  return slot;
+}
+
+}  // namespace libp2p_peerconnection
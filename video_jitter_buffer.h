@@ -0,0 +1,141 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_VIDEO_JITTER_BUFFER_H_
+#define _C_PC_VIDEO_JITTER_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "libmedia_codec/encoded_image.h"
+#include "rtc_base/numerics/sequence_number_util.h"
+
+namespace libp2p_peerconnection {
+
+// Holds complete video frames until their playout time, absorbing the
+// network jitter between frame assembly and the sink.
+//
+// The jitter is estimated from each frame's delay variation, its arrival
+// interval minus its RTP timestamp interval, with a Kalman filter over
+// [delay per byte, delay offset] as in the VCMJitterEstimator, so large
+// frames that take longer to arrive are not mistaken for jitter. Frames are
+// played out at their RTP time, mapped onto the local clock by the lowest
+// transit delay seen, plus the current delay: the estimated jitter, or the
+// base minimum delay when that is larger. The current delay follows the
+// target by at most kMaxDelayChangeMsPerS of media time, so a change does
+// not freeze or burst the playout.
+//
+// Frames are released in insertion order, which the packet buffer makes
+// decode order. Their metadata is kept in a ring of kMaxFrames; when it is
+// full the oldest frame is released early. In low latency mode frames are
+// released as soon as they are inserted, and only the estimate is kept up.
+//
+// Not thread safe.
+class VideoJitterBuffer {
+ public:
+  static constexpr size_t kMaxFrames = 64;
+  static constexpr int kMaxBaseMinimumDelayMs = 10000;
+  static constexpr int kMaxDelayMs = 2000;
+  static constexpr int kMaxDelayChangeMsPerS = 100;
+
+  using Frames = std::vector<std::shared_ptr<libmedia_codec::EncodedImage>>;
+
+  struct Stats {
+    int64_t frames = 0;
+    // Released before their playout time because the ring was full.
+    int64_t flushed_frames = 0;
+    int jitter_ms = 0;
+    int target_delay_ms = 0;
+    int current_delay_ms = 0;
+  };
+
+  VideoJitterBuffer();
+  ~VideoJitterBuffer();
+
+  VideoJitterBuffer(const VideoJitterBuffer&) = delete;
+  VideoJitterBuffer& operator=(const VideoJitterBuffer&) = delete;
+
+  // Fails outside [0, kMaxBaseMinimumDelayMs].
+  bool SetBaseMinimumDelayMs(int delay_ms);
+  int base_minimum_delay_ms() const { return base_minimum_delay_ms_; }
+
+  void SetLowLatencyMode(bool enabled);
+  bool low_latency_mode() const { return low_latency_mode_; }
+
+  // Returns the frames due by `now_ms`, including `frame` in low latency
+  // mode.
+  Frames InsertFrame(std::shared_ptr<libmedia_codec::EncodedImage> frame,
+                     int64_t receive_time_ms,
+                     int64_t now_ms);
+  Frames ReleaseFrames(int64_t now_ms);
+  // Playout time of the oldest frame, -1 when empty.
+  int64_t NextReleaseTimeMs() const;
+
+  Stats stats() const;
+
+ private:
+  struct Slot {
+    std::shared_ptr<libmedia_codec::EncodedImage> frame;
+    int64_t playout_time_ms = 0;
+  };
+
+  // Kalman filter over the frame delay variation.
+  void UpdateEstimate(double frame_delay_ms, double frame_size_delta);
+  void UpdateNoise(double residual_ms);
+  double JitterMs() const;
+  void UpdateCurrentDelay(int64_t media_interval_ms);
+  Slot PopFront();
+
+  int base_minimum_delay_ms_ = 0;
+  bool low_latency_mode_ = false;
+
+  std::array<Slot, kMaxFrames> ring_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+
+  webrtc::SeqNumUnwrapper<uint32_t> timestamp_unwrapper_;
+  int64_t last_timestamp_ms_ = -1;
+  int64_t last_receive_time_ms_ = -1;
+  double last_frame_size_ = 0;
+  // Lowest receive time minus RTP time seen, slowly relaxed upwards to
+  // follow clock drift.
+  double transit_offset_ms_ = 0;
+
+  // [delay per byte, delay offset] and its covariance.
+  double theta_[2] = {1.0 / (512e3 / 8), 0};
+  double covariance_[2][2] = {{1e-4, 0}, {0, 1e2}};
+  double noise_mean_ms_ = 0;
+  double noise_variance_ = 4.0;
+  int noise_samples_ = 1;
+  double average_frame_size_ = 500;
+  double frame_size_variance_ = 100;
+  double max_frame_size_ = 500;
+  int delay_samples_ = 0;
+
+  int current_delay_ms_ = 0;
+  Stats stats_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_VIDEO_JITTER_BUFFER_H_
@@ -0,0 +1,231 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#include "libp2p_peerconnection/video_packet_buffer.h"
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace libp2p_peerconnection {
+
+VideoPacketBuffer::VideoPacketBuffer(size_t capacity)
+    : mask_(capacity - 1), buffer_(capacity) {
+  RTC_DCHECK_GT(capacity, 0u);
+  RTC_DCHECK_EQ(capacity & mask_, 0u) << "capacity must be a power of two";
+}
+
+VideoPacketBuffer::~VideoPacketBuffer() = default;
+
+VideoPacketBuffer::InsertResult VideoPacketBuffer::InsertPacket(Packet packet) {
+  const int64_t sequence_number = unwrapper_.Unwrap(packet.sequence_number);
+  return Insert(sequence_number, std::move(packet), /*padding=*/false);
+}
+
+VideoPacketBuffer::InsertResult VideoPacketBuffer::InsertPadding(
+    uint16_t sequence_number) {
+  Packet packet;
+  packet.sequence_number = sequence_number;
+  return Insert(unwrapper_.Unwrap(sequence_number), std::move(packet),
+                /*padding=*/true);
+}
+
+void VideoPacketBuffer::Clear() {
+  for (Slot& slot : buffer_) {
+    ClearSlot(&slot);
+  }
+  next_sequence_number_ = -1;
+}
+
+VideoPacketBuffer::Slot* VideoPacketBuffer::GetSlot(int64_t sequence_number) {
+  Slot& slot = buffer_[sequence_number & mask_];
+  return slot.used && slot.sequence_number == sequence_number ? &slot
+                                                              : nullptr;
+}
+
+VideoPacketBuffer::InsertResult VideoPacketBuffer::Insert(
+    int64_t sequence_number,
+    Packet packet,
+    bool padding) {
+  InsertResult result;
+  if (next_sequence_number_ >= 0 && sequence_number < next_sequence_number_) {
+    ++stats_.discarded_packets;
+    return result;
+  }
+  Slot& slot = buffer_[sequence_number & mask_];
+  if (slot.used) {
+    if (slot.sequence_number == sequence_number) {
+      ++stats_.discarded_packets;
+      return result;
+    }
+    // While assembling, every stored packet is still needed: the gap at
+    // `next_sequence_number_` is older than the ring.
+    if (next_sequence_number_ >= 0) {
+      RTC_LOG(LS_WARNING) << "Video packet buffer full, clearing "
+                          << buffer_.size() << " packets.";
+      Clear();
+      ++stats_.cleared;
+      result.buffer_cleared = true;
+    }
+  }
+  slot.used = true;
+  slot.padding = padding;
+  slot.sequence_number = sequence_number;
+  slot.packet = std::move(packet);
+
+  if (next_sequence_number_ >= 0) {
+    FindFrames(&result);
+  }
+  // Still stuck behind a gap (or waiting for the first keyframe); a
+  // keyframe after it resynchronizes.
+  if (next_sequence_number_ < 0 ||
+      (next_sequence_number_ < sequence_number &&
+       !GetSlot(next_sequence_number_))) {
+    if (!padding && GetSlot(sequence_number)) {
+      FindKeyFrame(sequence_number, &result);
+    }
+  }
+  return result;
+}
+
+void VideoPacketBuffer::FindFrames(InsertResult* result) {
+  while (true) {
+    Slot* first = GetSlot(next_sequence_number_);
+    if (!first) {
+      return;
+    }
+    if (first->padding) {
+      ClearSlot(first);
+      ++next_sequence_number_;
+      continue;
+    }
+    const uint32_t timestamp = first->packet.timestamp;
+    int64_t last = next_sequence_number_;
+    while (!GetSlot(last)->packet.marker) {
+      Slot* next = GetSlot(last + 1);
+      if (!next) {
+        return;
+      }
+      // A sender that does not set the marker bit still changes the
+      // timestamp at the next frame.
+      if (next->padding || next->packet.timestamp != timestamp) {
+        break;
+      }
+      ++last;
+    }
+    ReleaseFrame(next_sequence_number_, last, result);
+  }
+}
+
+void VideoPacketBuffer::FindKeyFrame(int64_t sequence_number,
+                                     InsertResult* result) {
+  const uint32_t timestamp = GetSlot(sequence_number)->packet.timestamp;
+
+  int64_t first = sequence_number;
+  while (true) {
+    const Slot* previous = GetSlot(first - 1);
+    if (!previous) {
+      // Nothing known before it; only a packet starting with the SPS is
+      // certainly the first one of the keyframe.
+      if (!GetSlot(first)->packet.info.has_sps) {
+        return;
+      }
+      break;
+    }
+    if (previous->padding || previous->packet.timestamp != timestamp) {
+      break;
+    }
+    --first;
+    if (sequence_number - first >= static_cast<int64_t>(mask_)) {
+      return;
+    }
+  }
+  if (!GetSlot(first)->packet.info.starts_nalu) {
+    return;
+  }
+
+  int64_t last = sequence_number;
+  bool keyframe = false;
+  for (int64_t i = first; i < sequence_number; ++i) {
+    keyframe |= GetSlot(i)->packet.info.has_idr;
+  }
+  while (true) {
+    const Slot* slot = GetSlot(last);
+    keyframe |= slot->packet.info.has_idr;
+    if (slot->packet.marker) {
+      break;
+    }
+    const Slot* next = GetSlot(last + 1);
+    if (!next) {
+      return;
+    }
+    if (next->padding || next->packet.timestamp != timestamp) {
+      break;
+    }
+    ++last;
+  }
+  if (!keyframe) {
+    return;
+  }
+
+  // Whatever is older can no longer be decoded.
+  for (Slot& slot : buffer_) {
+    if (slot.used && slot.sequence_number < first) {
+      ClearSlot(&slot);
+    }
+  }
+  ReleaseFrame(first, last, result);
+  FindFrames(result);
+}
+
+void VideoPacketBuffer::ReleaseFrame(int64_t first,
+                                     int64_t last,
+                                     InsertResult* result) {
+  Frame frame;
+  frame.payloads.reserve(static_cast<size_t>(last - first + 1));
+  for (int64_t i = first; i <= last; ++i) {
+    Slot* slot = GetSlot(i);
+    if (i == first) {
+      frame.first_sequence_number = slot->packet.sequence_number;
+      frame.timestamp = slot->packet.timestamp;
+    }
+    frame.last_sequence_number = slot->packet.sequence_number;
+    frame.keyframe |= slot->packet.info.has_idr;
+    frame.annexb_size += slot->packet.info.annexb_size;
+    frame.receive_time_ms = slot->packet.receive_time_ms;
+    frame.payloads.push_back(
+        {std::move(slot->packet.payload), slot->packet.info.annexb_size});
+    ClearSlot(slot);
+  }
+  ++stats_.frames;
+  if (frame.keyframe) {
+    ++stats_.keyframes;
+  }
+  next_sequence_number_ = last + 1;
+  result->frames.push_back(std::move(frame));
+}
+
+void VideoPacketBuffer::ClearSlot(Slot* slot) {
+  slot->used = false;
+  slot->padding = false;
+  slot->packet.payload = rtc::CopyOnWriteBuffer();
+}
+
+}  // namespace libp2p_peerconnection
@@ -0,0 +1,140 @@
+/******************************************************************************
+ *  Copyright (c) 2025 The CRTC project authors . All Rights Reserved.
+ *
+ *  Please visit https://chensongpoixs.github.io for detail
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ ******************************************************************************/
+ /*****************************************************************************
+				   Author: chensong
+				   date:  2025-09-21
+
+
+
+ ******************************************************************************/
+
+#ifndef _C_PC_VIDEO_PACKET_BUFFER_H_
+#define _C_PC_VIDEO_PACKET_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "libp2p_peerconnection/h264_rtp_depacketizer.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/numerics/sequence_number_util.h"
+
+namespace libp2p_peerconnection {
+
+// Received H.264 packets of one SSRC, assembled into complete frames.
+//
+// Storage is a ring of power-of-two size indexed by the low bits of the
+// sequence number, like RtpPacketHistory on the send side. Packets keep a
+// reference to the received buffer; payloads are copied once, when the
+// caller writes the complete frame out with WriteH264AnnexB().
+//
+// Frames are released in sequence number order. A gap stops assembly until
+// it is filled, or until a keyframe completes after it. When the gap is not
+// filled before the ring wraps onto it the buffer is cleared, and nothing is
+// released until the next keyframe.
+//
+// Not thread safe; used on the network thread.
+class VideoPacketBuffer {
+ public:
+  static constexpr size_t kDefaultCapacity = 512;
+
+  struct Packet {
+    uint16_t sequence_number = 0;
+    uint32_t timestamp = 0;
+    bool marker = false;
+    H264PayloadInfo info;
+    // RTP payload, sharing the received packet's storage.
+    rtc::CopyOnWriteBuffer payload;
+    int64_t receive_time_ms = 0;
+  };
+
+  struct Frame {
+    struct Payload {
+      rtc::CopyOnWriteBuffer data;
+      size_t annexb_size = 0;
+    };
+
+    uint16_t first_sequence_number = 0;
+    uint16_t last_sequence_number = 0;
+    uint32_t timestamp = 0;
+    bool keyframe = false;
+    // Sum of the payloads' H264PayloadInfo::annexb_size.
+    size_t annexb_size = 0;
+    // Receive time of the packet that completed the frame.
+    int64_t receive_time_ms = 0;
+    std::vector<Payload> payloads;
+  };
+
+  struct InsertResult {
+    std::vector<Frame> frames;
+    // Packets were dropped to make room; a keyframe is needed to continue.
+    bool buffer_cleared = false;
+  };
+
+  struct Stats {
+    int64_t frames = 0;
+    int64_t keyframes = 0;
+    int64_t cleared = 0;
+    // Packets older than the last released frame, and duplicates.
+    int64_t discarded_packets = 0;
+  };
+
+  // `capacity` must be a power of two.
+  explicit VideoPacketBuffer(size_t capacity = kDefaultCapacity);
+  ~VideoPacketBuffer();
+
+  VideoPacketBuffer(const VideoPacketBuffer&) = delete;
+  VideoPacketBuffer& operator=(const VideoPacketBuffer&) = delete;
+
+  InsertResult InsertPacket(Packet packet);
+  // Padding only packets take up a sequence number but belong to no frame.
+  InsertResult InsertPadding(uint16_t sequence_number);
+
+  void Clear();
+
+  // True until the first keyframe, and again after the buffer was cleared.
+  bool waiting_for_keyframe() const { return next_sequence_number_ < 0; }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  struct Slot {
+    bool used = false;
+    bool padding = false;
+    int64_t sequence_number = 0;
+    Packet packet;
+  };
+
+  // Returns the slot holding unwrapped `sequence_number`, or nullptr.
+  Slot* GetSlot(int64_t sequence_number);
+  InsertResult Insert(int64_t sequence_number, Packet packet, bool padding);
+  // Releases complete frames starting at `next_sequence_number_`.
+  void FindFrames(InsertResult* result);
+  // Looks for a complete keyframe around `sequence_number` and continues
+  // from there, dropping everything before it.
+  void FindKeyFrame(int64_t sequence_number, InsertResult* result);
+  void ReleaseFrame(int64_t first, int64_t last, InsertResult* result);
+  void ClearSlot(Slot* slot);
+
+  const size_t mask_;
+  std::vector<Slot> buffer_;
+  webrtc::SeqNumUnwrapper<uint16_t> unwrapper_;
+  // Unwrapped sequence number the next frame starts at, -1 while waiting
+  // for a keyframe.
+  int64_t next_sequence_number_ = -1;
+  Stats stats_;
+};
+
+}  // namespace libp2p_peerconnection
+
+#endif  // _C_PC_VIDEO_PACKET_BUFFER_H_